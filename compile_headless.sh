@@ -0,0 +1,50 @@
+#!/bin/sh
+
+# Headless build without SFML:
+# libbulletworm_engine.a (engine, loaders, Game, Replay) and the bulletworm_sim batch simulator.
+# lib/headless/ provides the few header-only SFML types the engine uses.
+
+HEADLESS_OBJ_PATH=$PWD/headless_obj
+mkdir -p $HEADLESS_OBJ_PATH
+
+for SRC in \
+src/engine/*.c* \
+src/Game.cpp \
+src/Replay.cpp \
+src/Levels.cpp \
+src/ObjectBehaviorLoader.cpp \
+src/LevelPreparation.cpp \
+lib/src/bw_ext/Endianness.cpp \
+lib/src/bw_ext/MappedFile.cpp \
+lib/src/bw_ext/ObjParamEnumUtility.cpp \
+lib/src/bw_ext/WorkerPool.cpp \
+lib/src/bw_ext/random/*.c* \
+lib/src/bw_ext/stream/*.c*
+do
+g++ \
+-std=c++17 \
+-O2 \
+-DNDEBUG \
+-c $SRC \
+-I lib/include/ \
+-I lib/headless/ \
+-o $HEADLESS_OBJ_PATH/$(basename $SRC).o &
+done
+wait
+
+ar rcs libbulletworm_engine.a $HEADLESS_OBJ_PATH/*.o
+
+g++ \
+-std=c++17 \
+-O2 \
+-DNDEBUG \
+src/sim/*.c* \
+-I lib/include/ \
+-I lib/headless/ \
+-L . \
+-l bulletworm_engine \
+-l pthread \
+-o bulletworm_sim
+
+rm -rf $HEADLESS_OBJ_PATH
+HEADLESS_OBJ_PATH=
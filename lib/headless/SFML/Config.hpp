@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_CONFIG_HPP
+#define SFML_CONFIG_HPP
+
+// Headless stand-in for <SFML/Config.hpp>.
+// Only the fixed-size integer aliases are provided, so the engine and
+// the loaders can be compiled without SFML (see compile_headless.sh).
+
+namespace sf {
+
+typedef signed   char Int8;
+typedef unsigned char Uint8;
+
+typedef signed   short Int16;
+typedef unsigned short Uint16;
+
+typedef signed   int Int32;
+typedef unsigned int Uint32;
+
+typedef signed   long long Int64;
+typedef unsigned long long Uint64;
+
+} // namespace sf
+
+#endif // SFML_CONFIG_HPP
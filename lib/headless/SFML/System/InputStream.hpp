@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_INPUTSTREAM_HPP
+#define SFML_INPUTSTREAM_HPP
+#include <SFML/Config.hpp>
+
+// Headless stand-in for <SFML/System/InputStream.hpp>.
+// Same interface, so Levels and ObjectBehaviorLoader compile unchanged.
+
+namespace sf {
+
+class InputStream {
+public:
+
+    virtual ~InputStream() {}
+
+    virtual Int64 read(void* data, Int64 size) = 0;
+
+    virtual Int64 seek(Int64 position) = 0;
+
+    virtual Int64 tell() = 0;
+
+    virtual Int64 getSize() = 0;
+};
+
+} // namespace sf
+
+#endif // SFML_INPUTSTREAM_HPP
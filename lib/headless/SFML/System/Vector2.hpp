@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_VECTOR2_HPP
+#define SFML_VECTOR2_HPP
+
+// Headless stand-in for <SFML/System/Vector2.hpp>.
+// Mirrors the SFML 2.6 interface the engine relies on.
+
+namespace sf {
+
+template<class T>
+class Vector2 {
+public:
+
+    constexpr Vector2() noexcept : x(0), y(0) {}
+    constexpr Vector2(T X, T Y) noexcept : x(X), y(Y) {}
+
+    template<class U>
+    constexpr explicit Vector2(const Vector2<U>& vector) noexcept :
+        x(static_cast<T>(vector.x)),
+        y(static_cast<T>(vector.y)) {}
+
+    T x;
+    T y;
+};
+
+template<class T>
+constexpr Vector2<T> operator-(const Vector2<T>& right) noexcept {
+    return Vector2<T>(-right.x, -right.y);
+}
+
+template<class T>
+constexpr Vector2<T>& operator+=(Vector2<T>& left, const Vector2<T>& right) noexcept {
+    left.x += right.x;
+    left.y += right.y;
+    return left;
+}
+
+template<class T>
+constexpr Vector2<T>& operator-=(Vector2<T>& left, const Vector2<T>& right) noexcept {
+    left.x -= right.x;
+    left.y -= right.y;
+    return left;
+}
+
+template<class T>
+constexpr Vector2<T> operator+(const Vector2<T>& left, const Vector2<T>& right) noexcept {
+    return Vector2<T>(left.x + right.x, left.y + right.y);
+}
+
+template<class T>
+constexpr Vector2<T> operator-(const Vector2<T>& left, const Vector2<T>& right) noexcept {
+    return Vector2<T>(left.x - right.x, left.y - right.y);
+}
+
+template<class T>
+constexpr Vector2<T> operator*(const Vector2<T>& left, T right) noexcept {
+    return Vector2<T>(left.x * right, left.y * right);
+}
+
+template<class T>
+constexpr Vector2<T> operator*(T left, const Vector2<T>& right) noexcept {
+    return Vector2<T>(right.x * left, right.y * left);
+}
+
+template<class T>
+constexpr Vector2<T>& operator*=(Vector2<T>& left, T right) noexcept {
+    left.x *= right;
+    left.y *= right;
+    return left;
+}
+
+template<class T>
+constexpr Vector2<T> operator/(const Vector2<T>& left, T right) noexcept {
+    return Vector2<T>(left.x / right, left.y / right);
+}
+
+template<class T>
+constexpr Vector2<T>& operator/=(Vector2<T>& left, T right) noexcept {
+    left.x /= right;
+    left.y /= right;
+    return left;
+}
+
+template<class T>
+constexpr bool operator==(const Vector2<T>& left, const Vector2<T>& right) noexcept {
+    return (left.x == right.x) && (left.y == right.y);
+}
+
+template<class T>
+constexpr bool operator!=(const Vector2<T>& left, const Vector2<T>& right) noexcept {
+    return (left.x != right.x) || (left.y != right.y);
+}
+
+typedef Vector2<int>          Vector2i;
+typedef Vector2<unsigned int> Vector2u;
+typedef Vector2<float>        Vector2f;
+
+} // namespace sf
+
+#endif // SFML_VECTOR2_HPP
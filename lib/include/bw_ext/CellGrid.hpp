@@ -0,0 +1,197 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef CELL_GRID_HPP
+#define CELL_GRID_HPP
+#include "ElementStorage.hpp"
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+
+namespace Bulletworm {
+
+enum class GridLayout {
+	RowMajor,  // x + y * width, as Map
+	Tiled      // 8x8 blocks of cells are contiguous, the blocks are row-major
+};
+
+// 2 dimensional array with a selectable layout.
+// In the tiled one the 2D neighbourhood of a cell shares a few cache lines
+// (a column walk touches one line per 8 cells instead of one per cell).
+template<class T>
+class CellGrid {
+public:
+
+	static constexpr unsigned int TileBits = 3;
+	static constexpr unsigned int TileSide = 1u << TileBits;
+
+	CellGrid() noexcept = default;
+	CellGrid(const CellGrid<T>&) = default;
+	CellGrid(CellGrid<T>&&) noexcept;
+
+	CellGrid<T>& operator=(const CellGrid<T>&) = default;
+	CellGrid<T>& operator=(CellGrid<T>&&) noexcept;
+
+	void create(const sf::Vector2u& size, GridLayout layout, T element = T());
+
+	// refers to getElementCount(size, layout) elements laid out by an equal grid
+	// (read-only, they must outlive the grid)
+	void borrow(const sf::Vector2u& size, GridLayout layout, const T* elements) noexcept;
+
+	// including the padding of the tiled layout
+	static std::size_t getElementCount(const sf::Vector2u& size, GridLayout layout) noexcept;
+
+	std::size_t getIndex(int x, int y) const noexcept;
+
+	T& at(int x, int y) noexcept {
+		return m_elements[getIndex(x, y)];
+	}
+	const T& at(int x, int y) const noexcept {
+		return m_elements[getIndex(x, y)];
+	}
+
+	T& at(const sf::Vector2i& position) noexcept {
+		return at(position.x, position.y);
+	}
+	const T& at(const sf::Vector2i& position) const noexcept {
+		return at(position.x, position.y);
+	}
+
+	const sf::Vector2u& getSize() const noexcept {
+		return m_size;
+	}
+
+	GridLayout getLayout() const noexcept {
+		return m_layout;
+	}
+
+	// including the padding of the tiled layout
+	std::size_t getElementCount() const noexcept {
+		return m_elements.size();
+	}
+
+	const T* data() const noexcept {
+		return m_elements.data();
+	}
+
+private:
+
+	// the element count
+	std::size_t setShape(const sf::Vector2u& size, GridLayout layout) noexcept;
+
+	ElementStorage<T> m_elements;
+	sf::Vector2u m_size;
+	GridLayout m_layout = GridLayout::RowMajor;
+	std::size_t m_rowStride = 0;   // width for RowMajor, the tile row size for Tiled
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+CellGrid<T>::CellGrid(CellGrid<T>&& src) noexcept :
+	m_elements(std::move(src.m_elements)),
+	m_size(src.m_size),
+	m_layout(src.m_layout),
+	m_rowStride(src.m_rowStride) {
+	src.m_size = sf::Vector2u();
+	src.m_rowStride = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+CellGrid<T>& CellGrid<T>::operator=(CellGrid<T>&& src) noexcept {
+	if (this == &src)
+		return *this;
+
+	m_elements = std::move(src.m_elements);
+	m_size = src.m_size;
+	m_layout = src.m_layout;
+	m_rowStride = src.m_rowStride;
+
+	src.m_size = sf::Vector2u();
+	src.m_rowStride = 0;
+
+	return *this;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+void CellGrid<T>::create(const sf::Vector2u& size, GridLayout layout, T element) {
+	m_elements.assign(setShape(size, layout), element);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+void CellGrid<T>::borrow(const sf::Vector2u& size, GridLayout layout, const T* elements) noexcept {
+	m_elements.borrow(elements, setShape(size, layout));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+std::size_t CellGrid<T>::getElementCount(const sf::Vector2u& size, GridLayout layout) noexcept {
+	if (layout == GridLayout::Tiled) {
+		std::size_t tileColumns = (size.x + TileSide - 1) >> TileBits;
+		std::size_t tileRows = (size.y + TileSide - 1) >> TileBits;
+
+		return (tileColumns << (2 * TileBits)) * tileRows;
+	}
+
+	return (std::size_t)size.x * size.y;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+std::size_t CellGrid<T>::setShape(const sf::Vector2u& size, GridLayout layout) noexcept {
+	m_size = size;
+	m_layout = layout;
+
+	if (layout == GridLayout::Tiled)
+		m_rowStride = (std::size_t)((size.x + TileSide - 1) >> TileBits) << (2 * TileBits);
+	else
+		m_rowStride = size.x;
+
+	return getElementCount(size, layout);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+std::size_t CellGrid<T>::getIndex(int x, int y) const noexcept {
+	if (m_layout == GridLayout::RowMajor)
+		return (std::size_t)x + (std::size_t)y * m_rowStride;
+
+	std::size_t tile = ((std::size_t)y >> TileBits) * m_rowStride +
+		(((std::size_t)x >> TileBits) << (2 * TileBits));
+
+	return tile + (((std::size_t)y & (TileSide - 1)) << TileBits) + ((std::size_t)x & (TileSide - 1));
+}
+
+} // namespace Bulletworm
+
+#endif // !CELL_GRID_HPP
@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef CELL_JOURNAL_HPP
+#define CELL_JOURNAL_HPP
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Bulletworm {
+
+// Records the cells changed since the last clear, each one once.
+// Past the limit it only remembers that it overflowed (then the owner resets everything).
+// Marking never allocates.
+class CellJournal {
+public:
+
+	void create(std::size_t cellCount, std::size_t limit) {
+		m_marks.assign((cellCount + 63) / 64, 0);
+		m_cells.clear();
+		m_cells.reserve(limit);
+		m_limit = limit;
+		m_overflowed = false;
+	}
+
+	void mark(std::size_t cell) noexcept {
+		if (m_overflowed)
+			return;
+
+		std::uint64_t& word = m_marks[cell >> 6];
+		std::uint64_t bit = (std::uint64_t)1 << (cell & 63);
+
+		if (word & bit)
+			return;
+
+		if (m_cells.size() == m_limit) {
+			m_overflowed = true;
+			return;
+		}
+
+		word |= bit;
+		m_cells.push_back((std::uint32_t)cell);
+	}
+
+	void clear() noexcept {
+		if (m_overflowed) {
+			std::fill(m_marks.begin(), m_marks.end(), 0);
+		} else {
+			for (std::uint32_t cell : m_cells)
+				m_marks[cell >> 6] = 0;
+		}
+
+		m_cells.clear();
+		m_overflowed = false;
+	}
+
+	bool isOverflowed() const noexcept {
+		return m_overflowed;
+	}
+
+	const std::vector<std::uint32_t>& getCells() const noexcept {
+		return m_cells;
+	}
+
+private:
+
+	std::vector<std::uint64_t> m_marks; // One bit per cell
+	std::vector<std::uint32_t> m_cells; // Marked cells in order
+	std::size_t m_limit = 0;
+	bool m_overflowed = false;
+};
+
+} // namespace Bulletworm
+
+#endif // !CELL_JOURNAL_HPP
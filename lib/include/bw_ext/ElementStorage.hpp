@@ -0,0 +1,211 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+#ifndef ELEMENT_STORAGE_HPP
+#define ELEMENT_STORAGE_HPP
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Bulletworm {
+
+// Contiguous elements either owned (a vector) or borrowed from read-only memory
+// that outlives them (a mapped file). The borrowed ones must not be written,
+// a copy of a borrowing storage borrows the same memory.
+template<class T>
+class ElementStorage {
+public:
+
+	ElementStorage() noexcept = default;
+	ElementStorage(const ElementStorage<T>& src);
+	ElementStorage(ElementStorage<T>&& src) noexcept;
+
+	ElementStorage<T>& operator=(const ElementStorage<T>& src);
+	ElementStorage<T>& operator=(ElementStorage<T>&& src) noexcept;
+
+	// owned count copies of the element, the old memory is released
+	void assign(std::size_t count, const T& element);
+
+	// owned copy of [first, last)
+	void assign(const T* first, const T* last);
+
+	// owned, the owned elements are kept
+	void resize(std::size_t count);
+
+	void borrow(const T* elements, std::size_t count) noexcept;
+
+	void clear() noexcept {
+		std::vector<T>().swap(m_owned);
+		m_data = nullptr;
+		m_size = 0;
+		m_borrowed = false;
+	}
+
+	bool isBorrowed() const noexcept {
+		return m_borrowed;
+	}
+
+	std::size_t size() const noexcept {
+		return m_size;
+	}
+
+	bool empty() const noexcept {
+		return !m_size;
+	}
+
+	T* data() noexcept {
+		return m_data;
+	}
+	const T* data() const noexcept {
+		return m_data;
+	}
+
+	T& operator[](std::size_t i) noexcept {
+		return m_data[i];
+	}
+	const T& operator[](std::size_t i) const noexcept {
+		return m_data[i];
+	}
+
+	T& back() noexcept {
+		return m_data[m_size - 1];
+	}
+	const T& back() const noexcept {
+		return m_data[m_size - 1];
+	}
+
+	void swap(ElementStorage<T>& other) noexcept {
+		m_owned.swap(other.m_owned); // the buffers don't move
+		std::swap(m_data, other.m_data);
+		std::swap(m_size, other.m_size);
+		std::swap(m_borrowed, other.m_borrowed);
+	}
+
+private:
+
+	void own() noexcept {
+		m_data = m_owned.data();
+		m_size = m_owned.size();
+		m_borrowed = false;
+	}
+
+	std::vector<T> m_owned;
+	T* m_data = nullptr;       // m_owned.data() or the borrowed elements
+	std::size_t m_size = 0;
+	bool m_borrowed = false;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+ElementStorage<T>::ElementStorage(const ElementStorage<T>& src) :
+	m_owned(src.m_owned),
+	m_data(src.m_borrowed ? src.m_data : m_owned.data()),
+	m_size(src.m_size),
+	m_borrowed(src.m_borrowed) {}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+ElementStorage<T>::ElementStorage(ElementStorage<T>&& src) noexcept :
+	m_owned(std::move(src.m_owned)),
+	m_data(src.m_data),
+	m_size(src.m_size),
+	m_borrowed(src.m_borrowed) {
+	src.m_data = nullptr;
+	src.m_size = 0;
+	src.m_borrowed = false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+ElementStorage<T>& ElementStorage<T>::operator=(const ElementStorage<T>& src) {
+	if (this == &src)
+		return *this;
+
+	m_owned = src.m_owned;
+	m_data = src.m_borrowed ? src.m_data : m_owned.data();
+	m_size = src.m_size;
+	m_borrowed = src.m_borrowed;
+
+	return *this;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+ElementStorage<T>& ElementStorage<T>::operator=(ElementStorage<T>&& src) noexcept {
+	if (this == &src)
+		return *this;
+
+	m_owned = std::move(src.m_owned);
+	m_data = src.m_data;
+	m_size = src.m_size;
+	m_borrowed = src.m_borrowed;
+
+	src.m_data = nullptr;
+	src.m_size = 0;
+	src.m_borrowed = false;
+
+	return *this;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+void ElementStorage<T>::assign(std::size_t count, const T& element) {
+	std::vector<T>(count, element).swap(m_owned);
+	own();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+void ElementStorage<T>::assign(const T* first, const T* last) {
+	m_owned.assign(first, last);
+	own();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+void ElementStorage<T>::resize(std::size_t count) {
+	m_owned.resize(count);
+	own();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+void ElementStorage<T>::borrow(const T* elements, std::size_t count) noexcept {
+	std::vector<T>().swap(m_owned);
+	m_data = const_cast<T*>(elements);
+	m_size = count;
+	m_borrowed = true;
+}
+
+} // namespace Bulletworm
+
+#endif // !ELEMENT_STORAGE_HPP
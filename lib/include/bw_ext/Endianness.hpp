@@ -25,13 +25,52 @@
 
 #ifndef ENDIANNESS_HPP
 #define ENDIANNESS_HPP
+#include <cstddef>
 #include <cstdint>
 
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define BULLETWORM_BIG_ENDIAN 1
+#else
+#define BULLETWORM_BIG_ENDIAN 0
+#endif
+
+namespace sf {
+class InputStream;
+}
+
 namespace Bulletworm {
 
 std::uint32_t n2hl(std::uint32_t network);
 std::uint32_t h2nl(std::uint32_t host);
 
+// Reverses the bytes of count values (SSSE3/AVX2 shuffles where the target has them),
+// the spans are either the same or disjoint
+void swapByteOrder(const std::uint32_t* source, std::uint32_t* destination, std::size_t count) noexcept;
+
+// The whole span in place, nothing to do on a big-endian host
+inline void n2hl(std::uint32_t* values, std::size_t count) noexcept {
+#if BULLETWORM_BIG_ENDIAN
+    (void)values;
+    (void)count;
+#else
+    swapByteOrder(values, values, count);
+#endif
+}
+
+inline void h2nl(std::uint32_t* values, std::size_t count) noexcept {
+    n2hl(values, count);
+}
+
+// Converted copies
+void n2hl(const std::uint32_t* network, std::uint32_t* host, std::size_t count) noexcept;
+void h2nl(const std::uint32_t* host, std::uint32_t* network, std::size_t count) noexcept;
+
+// Reads count values and converts them from the network order (if endiannessRequired)
+// block by block while they are in the cache. False if the stream has fewer values.
+// A MappedFileInputStream is converted straight from its view, without the copy.
+[[nodiscard]] bool readN2hl(sf::InputStream& stream, std::uint32_t* values, std::size_t count,
+                            bool endiannessRequired = true);
+
 }
 
-#endif // ENDIANNESS_HPP
\ No newline at end of file
+#endif // ENDIANNESS_HPP
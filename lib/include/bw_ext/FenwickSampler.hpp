@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef FENWICK_SAMPLER_HPP
+#define FENWICK_SAMPLER_HPP
+#include "MultiFenwickTree.hpp"
+#include <cstdint>
+#include <limits>
+
+namespace Bulletworm {
+
+// MultiFenwickTree with the node width picked from the totals:
+// 32-bit nodes when every channel total fits, 64-bit ones otherwise.
+// The values can only go down to 0 and back up to the created ones,
+// so the created totals are the maximum prefix sums.
+template<std::size_t Channels>
+class FenwickSampler {
+public:
+
+	using Leaf = std::array<std::uint32_t, Channels>;
+
+	// leaves[channel] points to size values
+	void create(std::size_t size, const std::uint32_t* const* leaves);
+
+	// the same size and the same totals as created with
+	void reset(const std::uint32_t* const* leaves) noexcept {
+		if (m_wide)
+			m_wideTree.reset(leaves);
+		else
+			m_narrowTree.reset(leaves);
+	}
+
+	bool isWide() const noexcept {
+		return m_wide;
+	}
+
+	// The arrays of the used tree (see MultiFenwickTree)
+
+	std::size_t getNodeSize() const noexcept {
+		return m_wide ? MultiFenwickTree<std::uint64_t, Channels>::getNodeSize() :
+			MultiFenwickTree<std::uint32_t, Channels>::getNodeSize();
+	}
+
+	const void* getNodeData() const noexcept {
+		return m_wide ? m_wideTree.getNodeData() : m_narrowTree.getNodeData();
+	}
+
+	const Leaf* getLeafData() const noexcept {
+		return m_wide ? m_wideTree.getLeafData() : m_narrowTree.getLeafData();
+	}
+
+	// Refers to the arrays of a created sampler (read-only, they must outlive the sampler)
+	void borrow(bool wide, std::size_t size, const void* nodes, const Leaf* leaves) noexcept;
+
+	std::size_t getSize() const noexcept {
+		return m_wide ? m_wideTree.getSize() : m_narrowTree.getSize();
+	}
+
+	[[nodiscard]] std::uint64_t getTotal(std::size_t channel) const noexcept {
+		return m_wide ? m_wideTree.getTotal(channel) : m_narrowTree.getTotal(channel);
+	}
+
+	[[nodiscard]] std::uint32_t get(std::size_t channel, std::size_t i) const noexcept {
+		return m_wide ? m_wideTree.get(channel, i) : m_narrowTree.get(channel, i);
+	}
+
+	[[nodiscard]] const Leaf& getLeaf(std::size_t i) const noexcept {
+		return m_wide ? m_wideTree.getLeaf(i) : m_narrowTree.getLeaf(i);
+	}
+
+	void set(std::size_t channel, std::size_t i, std::uint32_t value) noexcept {
+		if (m_wide)
+			m_wideTree.set(channel, i, value);
+		else
+			m_narrowTree.set(channel, i, value);
+	}
+
+	void setAll(std::size_t i, const Leaf& values) noexcept {
+		if (m_wide)
+			m_wideTree.setAll(i, values);
+		else
+			m_narrowTree.setAll(i, values);
+	}
+
+	void closeAll(std::size_t i) noexcept {
+		setAll(i, Leaf{});
+	}
+
+	void restoreAll(std::size_t i, const Leaf& initialValues) noexcept {
+		setAll(i, initialValues);
+	}
+
+	// value < getTotal(channel)
+	[[nodiscard]] std::size_t rankQuery(std::size_t channel, std::uint64_t value) const noexcept {
+		return m_wide ? m_wideTree.rankQuery(channel, value) :
+			m_narrowTree.rankQuery(channel, (std::uint32_t)value);
+	}
+
+private:
+
+	MultiFenwickTree<std::uint32_t, Channels> m_narrowTree;
+	MultiFenwickTree<std::uint64_t, Channels> m_wideTree;
+	bool m_wide = false;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<std::size_t Channels>
+void FenwickSampler<Channels>::borrow(bool wide, std::size_t size,
+									  const void* nodes, const Leaf* leaves) noexcept {
+	if (wide) {
+		MultiFenwickTree<std::uint32_t, Channels>().swap(m_narrowTree);
+		m_wideTree.borrow(size, nodes, leaves);
+	} else {
+		MultiFenwickTree<std::uint64_t, Channels>().swap(m_wideTree);
+		m_narrowTree.borrow(size, nodes, leaves);
+	}
+
+	m_wide = wide;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<std::size_t Channels>
+void FenwickSampler<Channels>::create(std::size_t size, const std::uint32_t* const* leaves) {
+	// at most 2^32 leaves of 2^32 - 1, no overflow
+	bool wide = false;
+	for (std::size_t c = 0; c < Channels && !wide; ++c) {
+		std::uint64_t total = 0;
+		for (std::size_t i = 0; i < size; ++i)
+			total += leaves[c][i];
+		wide = (total > std::numeric_limits<std::uint32_t>::max());
+	}
+
+	// only one tree keeps its memory
+	if (wide) {
+		MultiFenwickTree<std::uint32_t, Channels>().swap(m_narrowTree);
+		m_wideTree.create(size, leaves);
+	} else {
+		MultiFenwickTree<std::uint64_t, Channels>().swap(m_wideTree);
+		m_narrowTree.create(size, leaves);
+	}
+
+	m_wide = wide;
+}
+
+} // namespace Bulletworm
+
+#endif // !FENWICK_SAMPLER_HPP
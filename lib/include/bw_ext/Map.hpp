@@ -25,8 +25,8 @@
 
 #ifndef MAP_HPP
 #define MAP_HPP
+#include "ElementStorage.hpp"
 #include <SFML/System/Vector2.hpp>
-#include <vector>
 
 namespace Bulletworm {
 
@@ -50,6 +50,9 @@ public:
 	void create(unsigned int width, unsigned int height, const T* elements);
 	void create(const sf::Vector2u& size, const T* elements);
 
+	// refers to the elements (read-only, they must outlive the map)
+	void borrow(const sf::Vector2u& size, const T* elements) noexcept;
+
 	T* data() noexcept {
 		return m_elements.data();
 	}
@@ -80,7 +83,7 @@ public:
 
 private:
 
-	std::vector<T> m_elements;   // Map elements
+	ElementStorage<T> m_elements;   // Map elements
 	sf::Vector2u m_size;         // Map size
 };
 
@@ -117,12 +120,12 @@ void Map<T>::create(unsigned int width, unsigned int height, T element) {
 	if (width && height) {
 		unsigned int area = width * height;
 
-		std::vector<T>(area, element).swap(m_elements);
+		m_elements.assign(area, element);
 
 		m_size.x = width;
 		m_size.y = height;
 	} else {
-		std::vector<T>().swap(m_elements);
+		m_elements.clear();
 
 		m_size.x = 0;
 		m_size.y = 0;
@@ -141,7 +144,7 @@ void Map<T>::create(unsigned int width, unsigned int height, const T* elements)
 		m_size.x = width;
 		m_size.y = height;
 	} else {
-		std::vector<T>().swap(m_elements);
+		m_elements.clear();
 
 		m_size.x = 0;
 		m_size.y = 0;
@@ -160,6 +163,12 @@ void Map<T>::create(const sf::Vector2u& size, const T* elements) {
 	create(size.x, size.y, elements);
 }
 
+template<class T>
+void Map<T>::borrow(const sf::Vector2u& size, const T* elements) noexcept {
+	m_elements.borrow(elements, (std::size_t)size.x * size.y);
+	m_size = size;
+}
+
 template<class T>
 T& Map<T>::at(int x, int y) noexcept {
 	return m_elements[x + (std::size_t)y * m_size.x];
@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+#include <cstddef>
+#include <filesystem>
+
+namespace Bulletworm {
+
+// A whole file mapped read-only into memory.
+// The pages are read on the first access, so opening a huge file costs nothing.
+class MappedFile {
+public:
+
+	MappedFile() noexcept = default;
+
+	~MappedFile() noexcept;
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	MappedFile(MappedFile&& src) noexcept;
+	MappedFile& operator=(MappedFile&& src) noexcept;
+
+	// Unmaps the previous file; false if the file can't be mapped (or is empty)
+	[[nodiscard]] bool open(const std::filesystem::path& filename) noexcept;
+
+	void close() noexcept;
+
+	// Hints the kernel that the pages are read front to back (larger read-ahead, early reclaim)
+	void adviseSequential() const noexcept;
+
+	bool isOpen() const noexcept {
+		return m_data != nullptr;
+	}
+
+	// page aligned
+	const void* getData() const noexcept {
+		return m_data;
+	}
+
+	std::size_t getSize() const noexcept {
+		return m_size;
+	}
+
+private:
+
+	const void* m_data = nullptr;
+	std::size_t m_size = 0;
+};
+
+} // namespace Bulletworm
+
+#endif // !MAPPED_FILE_HPP
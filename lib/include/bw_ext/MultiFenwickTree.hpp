@@ -0,0 +1,279 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef MULTI_FENWICK_TREE_HPP
+#define MULTI_FENWICK_TREE_HPP
+#include <algorithm>
+#include "ElementStorage.hpp"
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+namespace Bulletworm {
+
+// the power of 2 not less than the node size (at most 64)
+constexpr std::size_t getMultiFenwickNodeAlignment(std::size_t nodeSize) {
+	std::size_t alignment = 1;
+	while (alignment < nodeSize && alignment < 64)
+		alignment <<= 1;
+	return alignment;
+}
+
+// Several Fenwick trees over the same indices with the channels interleaved per node,
+// so an update of all channels walks the tree once.
+// The current leaf values are cached, reading one doesn't walk the tree.
+template<class Value, std::size_t Channels>
+class MultiFenwickTree {
+public:
+
+	static_assert(std::is_unsigned_v<Value> && std::is_integral_v<Value>);
+	static_assert(Channels > 0);
+
+	using Leaf = std::array<std::uint32_t, Channels>;
+
+	// leaves[channel] points to size values
+	void create(std::size_t size, const std::uint32_t* const* leaves);
+
+	// the same size as created with
+	void reset(const std::uint32_t* const* leaves) noexcept;
+
+	// The arrays of a created tree, to keep them somewhere else (see borrow)
+
+	static std::size_t getNodeSize() noexcept;
+	static std::size_t getNodeCount(std::size_t size) noexcept;  // and the leaf count - 1
+
+	const void* getNodeData() const noexcept {
+		return m_nodes.data();
+	}
+	const Leaf* getLeafData() const noexcept {
+		return m_leaves.data();
+	}
+
+	// Refers to the arrays of a created tree of the size (read-only, they must outlive the tree),
+	// nodes are aligned as the ones of getNodeData
+	void borrow(std::size_t size, const void* nodes, const Leaf* leaves) noexcept;
+
+	void swap(MultiFenwickTree<Value, Channels>& other) noexcept {
+		m_nodes.swap(other.m_nodes);
+		m_leaves.swap(other.m_leaves);
+		std::swap(m_size, other.m_size);
+	}
+
+	std::size_t getSize() const noexcept {
+		return m_size;
+	}
+
+	[[nodiscard]] Value getTotal(std::size_t channel) const noexcept;
+
+	[[nodiscard]] std::uint32_t get(std::size_t channel, std::size_t i) const noexcept {
+		return m_leaves[i][channel];
+	}
+
+	[[nodiscard]] const Leaf& getLeaf(std::size_t i) const noexcept {
+		return m_leaves[i];
+	}
+
+	void set(std::size_t channel, std::size_t i, std::uint32_t value) noexcept;
+
+	// set all the channels of the leaf at once
+	void setAll(std::size_t i, const Leaf& values) noexcept;
+
+	void closeAll(std::size_t i) noexcept {
+		setAll(i, Leaf{});
+	}
+
+	void restoreAll(std::size_t i, const Leaf& initialValues) noexcept {
+		setAll(i, initialValues);
+	}
+
+	// the leaf index i where prefix(i) <= value < prefix(i + 1), value < getTotal(channel)
+	[[nodiscard]] std::size_t rankQuery(std::size_t channel, Value value) const noexcept;
+
+private:
+
+	// one node is within a cache line
+	struct alignas(getMultiFenwickNodeAlignment(sizeof(Value) * Channels)) Node {
+		std::array<Value, Channels> values;
+	};
+
+	static std::size_t getNext(std::size_t i) noexcept {
+		return i + (i & (~i + 1));
+	}
+
+	void build(const std::uint32_t* const* leaves) noexcept;
+
+	ElementStorage<Node> m_nodes;  // 1-based, the node count is a power of 2
+	ElementStorage<Leaf> m_leaves; // Current leaf values
+	std::size_t m_size = 0;     // Leaf count
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class Value, std::size_t Channels>
+void MultiFenwickTree<Value, Channels>::create(std::size_t size, const std::uint32_t* const* leaves) {
+	std::size_t nodeCount = getNodeCount(size);
+
+	m_size = size;
+	m_nodes.resize(nodeCount + 1);
+	m_leaves.resize(nodeCount);
+	build(leaves);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class Value, std::size_t Channels>
+std::size_t MultiFenwickTree<Value, Channels>::getNodeSize() noexcept {
+	return sizeof(Node);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class Value, std::size_t Channels>
+std::size_t MultiFenwickTree<Value, Channels>::getNodeCount(std::size_t size) noexcept {
+	std::size_t nodeCount = 0;
+	if (size) {
+		nodeCount = 1;
+		while (nodeCount < size)
+			nodeCount <<= 1;
+	}
+
+	return nodeCount;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class Value, std::size_t Channels>
+void MultiFenwickTree<Value, Channels>::borrow(std::size_t size, const void* nodes,
+											   const Leaf* leaves) noexcept {
+	std::size_t nodeCount = getNodeCount(size);
+
+	m_size = size;
+	m_nodes.borrow(static_cast<const Node*>(nodes), nodeCount + 1);
+	m_leaves.borrow(leaves, nodeCount);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class Value, std::size_t Channels>
+void MultiFenwickTree<Value, Channels>::reset(const std::uint32_t* const* leaves) noexcept {
+	build(leaves);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class Value, std::size_t Channels>
+void MultiFenwickTree<Value, Channels>::build(const std::uint32_t* const* leaves) noexcept {
+	std::size_t nodeCount = m_leaves.size();
+
+	// one pass, a node pulls its children (i - 1, i - 2, i - 4, ... below its lowest bit)
+	m_nodes[0] = Node{};
+	for (std::size_t i = 1; i <= nodeCount; ++i) {
+		Leaf& leaf = m_leaves[i - 1];
+		Node& node = m_nodes[i];
+
+		for (std::size_t c = 0; c < Channels; ++c) {
+			leaf[c] = (i <= m_size ? leaves[c][i - 1] : 0);
+			node.values[c] = leaf[c];
+		}
+
+		std::size_t lowest = i & (~i + 1);
+		for (std::size_t step = 1; step < lowest; step <<= 1)
+			for (std::size_t c = 0; c < Channels; ++c)
+				node.values[c] += m_nodes[i - step].values[c];
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class Value, std::size_t Channels>
+Value MultiFenwickTree<Value, Channels>::getTotal(std::size_t channel) const noexcept {
+	// the root of the power of 2 tree covers all the leaves
+	return m_nodes.size() > 1 ? m_nodes.back().values[channel] : 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class Value, std::size_t Channels>
+void MultiFenwickTree<Value, Channels>::set(std::size_t channel, std::size_t i,
+											std::uint32_t value) noexcept {
+	assert(i < m_size);
+
+	Value delta = (Value)value - (Value)m_leaves[i][channel];
+	if (!delta)
+		return;
+
+	m_leaves[i][channel] = value;
+
+	std::size_t nodeCount = m_leaves.size();
+	for (std::size_t k = i + 1; k <= nodeCount; k = getNext(k))
+		m_nodes[k].values[channel] += delta;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class Value, std::size_t Channels>
+void MultiFenwickTree<Value, Channels>::setAll(std::size_t i, const Leaf& values) noexcept {
+	assert(i < m_size);
+
+	std::array<Value, Channels> delta;
+	bool changed = false;
+
+	for (std::size_t c = 0; c < Channels; ++c) {
+		delta[c] = (Value)values[c] - (Value)m_leaves[i][c];
+		changed |= (delta[c] != 0);
+	}
+
+	if (!changed)
+		return;
+
+	m_leaves[i] = values;
+
+	std::size_t nodeCount = m_leaves.size();
+	for (std::size_t k = i + 1; k <= nodeCount; k = getNext(k))
+		for (std::size_t c = 0; c < Channels; ++c)
+			m_nodes[k].values[c] += delta[c];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class Value, std::size_t Channels>
+std::size_t MultiFenwickTree<Value, Channels>::rankQuery(std::size_t channel,
+														 Value value) const noexcept {
+	std::size_t nodeCount = m_leaves.size();
+	std::size_t i = 0;
+
+	for (std::size_t j = nodeCount; j > 0; j >>= 1) {
+		if (i + j <= nodeCount && m_nodes[i + j].values[channel] <= value) {
+			value -= m_nodes[i + j].values[channel];
+			i += j;
+		}
+	}
+	return i;
+}
+
+} // namespace Bulletworm
+
+#endif // !MULTI_FENWICK_TREE_HPP
@@ -0,0 +1,242 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef PAGED_MAP_HPP
+#define PAGED_MAP_HPP
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Bulletworm {
+
+// 2 dimensional sparse vector for the huge maps.
+// The cells live in square tiles of (1 << TileBits)^2 elements, a tile is taken
+// from the pool on the first write and returned when its last used cell is erased.
+// References to the cells stay valid until the cell is erased.
+template<class T, unsigned int TileBits = 6>
+class PagedMap {
+public:
+
+	static constexpr unsigned int TileSide = 1u << TileBits;
+	static constexpr std::size_t TileArea = (std::size_t)TileSide * TileSide;
+
+	PagedMap() noexcept = default;
+	PagedMap(const PagedMap<T, TileBits>& src);
+	PagedMap(PagedMap<T, TileBits>&&) noexcept = default;
+
+	PagedMap<T, TileBits>& operator=(const PagedMap<T, TileBits>& src);
+	PagedMap<T, TileBits>& operator=(PagedMap<T, TileBits>&&) noexcept = default;
+
+	// the unused cells are equal to emptyElement
+	void create(const sf::Vector2u& size, T emptyElement);
+
+	// erase all the cells, the tiles stay in the pool
+	void clear() noexcept;
+
+	// emptyElement if the cell is unused
+	const T& at(int x, int y) const noexcept;
+
+	// mark the cell used (allocates its tile if needed)
+	T& set(int x, int y);
+
+	// reset the cell to emptyElement and mark it unused
+	void erase(int x, int y) noexcept;
+
+	const sf::Vector2u& getSize() const noexcept {
+		return m_size;
+	}
+
+	std::size_t getTileCount() const noexcept {
+		return m_tilePool.size() - m_freeTiles.size();
+	}
+
+private:
+
+	static constexpr std::uint32_t NoTile = 0xffffffffu;
+
+	struct Tile {
+		std::array<T, TileArea> cells;
+		std::array<std::uint64_t, (TileArea + 63) / 64> used;
+		std::size_t usedCount;
+	};
+
+	std::size_t getTileIndex(int x, int y) const noexcept {
+		return (std::size_t)((unsigned int)x >> TileBits) +
+			(std::size_t)((unsigned int)y >> TileBits) * m_tileColumns;
+	}
+
+	static std::size_t getCellIndex(int x, int y) noexcept {
+		return ((unsigned int)x & (TileSide - 1)) +
+			(std::size_t)((unsigned int)y & (TileSide - 1)) * TileSide;
+	}
+
+	void releaseTile(std::size_t tileIndex) noexcept;
+
+	std::vector<std::uint32_t> m_tiles;                // Tile directory, pool indices or NoTile
+	std::vector<std::unique_ptr<Tile>> m_tilePool;     // Allocated tiles (used and free)
+	std::vector<std::uint32_t> m_freeTiles;            // Free pool indices
+	std::size_t m_tileColumns = 0;
+	sf::Vector2u m_size;
+	T m_emptyElement{};
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T, unsigned int TileBits>
+PagedMap<T, TileBits>::PagedMap(const PagedMap<T, TileBits>& src) :
+	m_tiles(src.m_tiles),
+	m_freeTiles(src.m_freeTiles),
+	m_tileColumns(src.m_tileColumns),
+	m_size(src.m_size),
+	m_emptyElement(src.m_emptyElement) {
+	m_tilePool.reserve(src.m_tilePool.size());
+	for (const auto& tile : src.m_tilePool)
+		m_tilePool.push_back(std::make_unique<Tile>(*tile));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T, unsigned int TileBits>
+PagedMap<T, TileBits>& PagedMap<T, TileBits>::operator=(const PagedMap<T, TileBits>& src) {
+	if (this == &src)
+		return *this;
+
+	PagedMap<T, TileBits> tmp(src);
+	*this = std::move(tmp);
+	return *this;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T, unsigned int TileBits>
+void PagedMap<T, TileBits>::create(const sf::Vector2u& size, T emptyElement) {
+	m_tileColumns = (size.x + TileSide - 1) >> TileBits;
+	std::size_t tileRows = (size.y + TileSide - 1) >> TileBits;
+
+	m_emptyElement = emptyElement;
+	m_size = size;
+
+	// the pool is kept (the same tile size)
+	m_tiles.assign(m_tileColumns * tileRows, NoTile);
+	m_freeTiles.clear();
+	for (std::size_t i = m_tilePool.size(); i > 0; --i)
+		m_freeTiles.push_back((std::uint32_t)i - 1);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T, unsigned int TileBits>
+void PagedMap<T, TileBits>::clear() noexcept {
+	for (std::size_t i = 0; i < m_tiles.size(); ++i)
+		if (m_tiles[i] != NoTile)
+			releaseTile(i);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T, unsigned int TileBits>
+const T& PagedMap<T, TileBits>::at(int x, int y) const noexcept {
+	std::uint32_t tile = m_tiles[getTileIndex(x, y)];
+
+	if (tile == NoTile)
+		return m_emptyElement;
+
+	return m_tilePool[tile]->cells[getCellIndex(x, y)];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T, unsigned int TileBits>
+T& PagedMap<T, TileBits>::set(int x, int y) {
+	std::uint32_t& tile = m_tiles[getTileIndex(x, y)];
+
+	if (tile == NoTile) {
+		if (m_freeTiles.empty()) {
+			m_tilePool.push_back(std::make_unique<Tile>());
+			tile = (std::uint32_t)m_tilePool.size() - 1;
+
+			// the free list has room for the whole pool (releasing doesn't allocate)
+			m_freeTiles.reserve(m_tilePool.size());
+		} else {
+			tile = m_freeTiles.back();
+			m_freeTiles.pop_back();
+		}
+
+		Tile& newTile = *m_tilePool[tile];
+		newTile.cells.fill(m_emptyElement);
+		newTile.used.fill(0);
+		newTile.usedCount = 0;
+	}
+
+	Tile& current = *m_tilePool[tile];
+	std::size_t cell = getCellIndex(x, y);
+	std::uint64_t bit = (std::uint64_t)1 << (cell & 63);
+
+	if (!(current.used[cell >> 6] & bit)) {
+		current.used[cell >> 6] |= bit;
+		++current.usedCount;
+	}
+
+	return current.cells[cell];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T, unsigned int TileBits>
+void PagedMap<T, TileBits>::erase(int x, int y) noexcept {
+	std::size_t tileIndex = getTileIndex(x, y);
+	std::uint32_t tile = m_tiles[tileIndex];
+
+	if (tile == NoTile)
+		return;
+
+	Tile& current = *m_tilePool[tile];
+	std::size_t cell = getCellIndex(x, y);
+	std::uint64_t bit = (std::uint64_t)1 << (cell & 63);
+
+	if (!(current.used[cell >> 6] & bit))
+		return;
+
+	current.used[cell >> 6] &= ~bit;
+	current.cells[cell] = m_emptyElement;
+
+	if (--current.usedCount == 0)
+		releaseTile(tileIndex);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T, unsigned int TileBits>
+void PagedMap<T, TileBits>::releaseTile(std::size_t tileIndex) noexcept {
+	m_freeTiles.push_back(m_tiles[tileIndex]);
+	m_tiles[tileIndex] = NoTile;
+}
+
+} // namespace Bulletworm
+
+#endif // !PAGED_MAP_HPP
@@ -29,6 +29,7 @@
 #include <SFML/Graphics/Transformable.hpp>
 #include <SFML/System/Time.hpp>
 #include <SFML/Graphics/Vertex.hpp>
+#include <bw_ext/random/RandomizerImpl.hpp>
 #include <vector>
 #include <cstdint>
 #include <cmath>
@@ -44,6 +45,9 @@ public:
 
 	void init(std::size_t count);
 
+	// The particles have their own random stream
+	void setSeed(std::uint64_t seed) noexcept;
+
 	void update(sf::Time elapsed) noexcept;
 
 	void awake(float particleRadius,
@@ -73,8 +77,13 @@ private:
 		sf::Time constLifetime;
 	};
 
+	// angle, speed, lifetime, distance, rotation and color of a particle
+	static constexpr std::size_t RandomsPerParticle = 6;
+
 	std::vector<Particle> m_particles;
 	std::vector<sf::Vertex> m_vertices;
+	std::vector<float> m_randoms; // drawn for a whole burst at once
+	RandomizerImpl m_randomizer;
 };
 
 }
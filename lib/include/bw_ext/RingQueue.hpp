@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef RING_QUEUE_HPP
+#define RING_QUEUE_HPP
+#include <vector>
+#include <cstddef>
+
+namespace Bulletworm {
+
+// FIFO queue in a power of 2 ring.
+// The storage is allocated on the first push and grows (doubles) only on overflow,
+// clear() keeps it, so a steady stream of elements does not allocate at all.
+template<class T>
+class RingQueue {
+public:
+
+	static constexpr std::size_t InitialCapacity = 16;
+
+	RingQueue() noexcept = default;
+	RingQueue(const RingQueue<T>&) = default;
+	RingQueue(RingQueue<T>&&) noexcept;
+
+	RingQueue<T>& operator=(const RingQueue<T>&) = default;
+	RingQueue<T>& operator=(RingQueue<T>&&) noexcept;
+
+	explicit RingQueue(std::size_t capacity);
+
+	void push(const T& element);
+
+	T& front() noexcept {
+		return m_elements[m_head];
+	}
+	const T& front() const noexcept {
+		return m_elements[m_head];
+	}
+
+	void pop() noexcept {
+		m_head = (m_head + 1) & (m_elements.size() - 1);
+		--m_size;
+	}
+
+	// Move at most count front elements to the array, returns the number of them
+	std::size_t pop(T* elements, std::size_t count) noexcept;
+
+	// The storage is kept
+	void clear() noexcept {
+		m_head = 0;
+		m_size = 0;
+	}
+
+	bool empty() const noexcept {
+		return m_size == 0;
+	}
+
+	std::size_t size() const noexcept {
+		return m_size;
+	}
+
+	std::size_t capacity() const noexcept {
+		return m_elements.size();
+	}
+
+private:
+
+	void grow();
+
+	std::vector<T> m_elements;   // the size is 0 or a power of 2
+	std::size_t m_head = 0;
+	std::size_t m_size = 0;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+RingQueue<T>::RingQueue(std::size_t capacity) {
+	std::size_t powerOf2 = 1;
+	while (powerOf2 < capacity)
+		powerOf2 <<= 1;
+
+	m_elements.resize(powerOf2);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+RingQueue<T>::RingQueue(RingQueue<T>&& src) noexcept :
+	m_elements(std::move(src.m_elements)),
+	m_head(src.m_head),
+	m_size(src.m_size) {
+	src.m_elements.clear();
+	src.m_head = 0;
+	src.m_size = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+RingQueue<T>& RingQueue<T>::operator=(RingQueue<T>&& src) noexcept {
+	if (this == &src)
+		return *this;
+
+	m_elements = std::move(src.m_elements);
+	m_head = src.m_head;
+	m_size = src.m_size;
+
+	src.m_elements.clear();
+	src.m_head = 0;
+	src.m_size = 0;
+
+	return *this;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+void RingQueue<T>::push(const T& element) {
+	if (m_size == m_elements.size())
+		grow();
+
+	m_elements[(m_head + m_size) & (m_elements.size() - 1)] = element;
+	++m_size;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+std::size_t RingQueue<T>::pop(T* elements, std::size_t count) noexcept {
+	if (count > m_size)
+		count = m_size;
+
+	std::size_t mask = m_elements.size() - 1;
+
+	for (std::size_t i = 0; i < count; ++i)
+		elements[i] = std::move(m_elements[(m_head + i) & mask]);
+
+	m_head = (m_head + count) & mask;
+	m_size -= count;
+
+	return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class T>
+void RingQueue<T>::grow() {
+	std::vector<T> elements(m_elements.empty() ? InitialCapacity : m_elements.size() * 2);
+
+	// unwrap the ring at the beginning of the new storage
+	for (std::size_t i = 0; i < m_size; ++i)
+		elements[i] = std::move(m_elements[(m_head + i) & (m_elements.size() - 1)]);
+
+	m_elements.swap(elements);
+	m_head = 0;
+}
+
+} // namespace Bulletworm
+
+#endif // !RING_QUEUE_HPP
@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+#ifndef RUN_LENGTH_MAP_HPP
+#define RUN_LENGTH_MAP_HPP
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Bulletworm {
+
+// Read-only 2 dimensional map kept as (count, value) chunks in row-major order,
+// the way data.bin stores the level maps. The chunks are not copied (they must outlive
+// the map), only the end index of every chunk is kept: O(log runs) random access.
+class RunLengthMap {
+public:
+
+	// Sequential row-major access, O(1) per element
+	class Reader {
+	public:
+
+		explicit Reader(const std::uint32_t* chunks) noexcept :
+			m_chunk(chunks), m_left(chunks ? chunks[0] : 0) {}
+
+		std::uint32_t next() noexcept {
+			while (!m_left) {
+				m_chunk += 2;
+				m_left = m_chunk[0];
+			}
+
+			--m_left;
+			return m_chunk[1];
+		}
+
+	private:
+		const std::uint32_t* m_chunk;
+		std::uint32_t m_left;
+	};
+
+	// Returns false if the chunks don't cover the area exactly
+	[[nodiscard]] bool assign(const std::uint32_t* chunks, const sf::Vector2u& size) {
+		std::size_t area = (std::size_t)size.x * size.y;
+		std::size_t end = 0;
+
+		m_chunks = chunks;
+		m_size = size;
+		m_chunkEnds.clear();
+
+		while (end < area) {
+			end += chunks[m_chunkEnds.size() * 2];
+			m_chunkEnds.push_back(end);
+		}
+
+		return end == area;
+	}
+
+	std::uint32_t at(int x, int y) const noexcept {
+		return m_chunks[findChunk(x + (std::size_t)y * m_size.x) * 2 + 1];
+	}
+
+	std::uint32_t at(const sf::Vector2i& position) const noexcept {
+		return at(position.x, position.y);
+	}
+
+	// f(x, length, value) for the runs of the row from left to right
+	template<class F>
+	void forEachRowRun(unsigned int y, F&& f) const {
+		std::size_t rowFirst = (std::size_t)y * m_size.x;
+		std::size_t rowEnd = rowFirst + m_size.x;
+
+		for (std::size_t chunk = findChunk(rowFirst), first = rowFirst; first < rowEnd; ++chunk) {
+			std::size_t last = std::min(m_chunkEnds[chunk], rowEnd);
+
+			if (last > first)
+				f((unsigned int)(first - rowFirst), (unsigned int)(last - first), m_chunks[chunk * 2 + 1]);
+
+			first = last;
+		}
+	}
+
+	// All the elements in row-major order
+	void expand(std::uint32_t* elements) const {
+		std::size_t first = 0;
+
+		for (std::size_t chunk = 0; chunk < m_chunkEnds.size(); ++chunk) {
+			std::fill(elements + first, elements + m_chunkEnds[chunk], m_chunks[chunk * 2 + 1]);
+			first = m_chunkEnds[chunk];
+		}
+	}
+
+	Reader getReader() const noexcept {
+		return Reader(m_chunks);
+	}
+
+	const sf::Vector2u& getSize() const noexcept {
+		return m_size;
+	}
+
+	std::size_t getRunCount() const noexcept {
+		return m_chunkEnds.size();
+	}
+
+private:
+
+	// the chunk containing the element
+	std::size_t findChunk(std::size_t index) const noexcept {
+		return std::size_t(std::upper_bound(m_chunkEnds.begin(), m_chunkEnds.end(), index) -
+						   m_chunkEnds.begin());
+	}
+
+	const std::uint32_t* m_chunks = nullptr;
+	std::vector<std::size_t> m_chunkEnds;
+	sf::Vector2u m_size;
+};
+
+} // namespace Bulletworm
+
+#endif // !RUN_LENGTH_MAP_HPP
@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef UNDO_TRAIL_HPP
+#define UNDO_TRAIL_HPP
+#include <cstddef>
+#include <vector>
+
+namespace Bulletworm {
+
+// The previous values of the changed slots, the newest last.
+// A mark is the trail size: rewinding to it hands the values back newest first,
+// so every slot ends with the value it had at the mark (O(the changes since)).
+// The slot is any key the owner understands (an index, a step ID).
+template<class T>
+class UndoTrail {
+public:
+
+	struct Entry {
+		std::size_t slot;
+		T value;
+	};
+
+	void push(std::size_t slot, const T& value) {
+		m_entries.push_back(Entry{ slot, value });
+	}
+
+	std::size_t getMark() const noexcept {
+		return m_entries.size();
+	}
+
+	// restore(slot, value) for every entry after the mark
+	template<class Restore>
+	void rewind(std::size_t mark, Restore&& restore) {
+		while (m_entries.size() > mark) {
+			const Entry& entry = m_entries.back();
+			restore(entry.slot, entry.value);
+			m_entries.pop_back();
+		}
+	}
+
+	// The storage is kept
+	void clear() noexcept {
+		m_entries.clear();
+	}
+
+private:
+
+	std::vector<Entry> m_entries;
+};
+
+} // namespace Bulletworm
+
+#endif // !UNDO_TRAIL_HPP
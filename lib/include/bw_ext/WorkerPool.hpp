@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Bulletworm {
+
+// Threads waiting for the jobs, every job runs on all of them.
+// The thread calling run() only waits, so the pool is not reentrant.
+class WorkerPool {
+public:
+
+	// 0 means hardware concurrency
+	explicit WorkerPool(unsigned int threadCount = 0);
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	~WorkerPool();
+
+	unsigned int getThreadCount() const noexcept {
+		return (unsigned int)m_threads.size();
+	}
+
+	// job(worker index) on every worker, returns when all of them are done
+	void run(const std::function<void(unsigned int)>& job);
+
+	// task(index) for every index in [0, taskCount), the free workers take the next ones;
+	// returns when all of them are done
+	void runTasks(std::size_t taskCount, const std::function<void(std::size_t)>& task);
+
+private:
+
+	void work(unsigned int index);
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	const std::function<void(unsigned int)>* m_job = nullptr;
+	std::uint64_t m_generation = 0;
+	unsigned int m_busyCount = 0;
+	bool m_stop = false;
+};
+
+} // namespace Bulletworm
+
+#endif // !WORKER_POOL_HPP
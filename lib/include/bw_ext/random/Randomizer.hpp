@@ -26,6 +26,8 @@
 #ifndef RANDOMIZER_HPP
 #define RANDOMIZER_HPP
 #include <cstdint>
+#include <cstddef>
+#include <limits>
 
 namespace Bulletworm {
 
@@ -34,6 +36,22 @@ public:
 
 	[[nodiscard]] virtual std::uint64_t get(std::uint64_t least, std::uint64_t greatest) = 0;
 
+	// values[i] in [0, bound), the full range if bound is 0;
+	// the same numbers as the get calls in a row
+	virtual void fill(std::uint64_t* values, std::size_t count, std::uint64_t bound) {
+		std::uint64_t greatest = bound ? bound - 1 : std::numeric_limits<std::uint64_t>::max();
+
+		for (std::size_t i = 0; i < count; ++i)
+			values[i] = get(0, greatest);
+	}
+
+	// values[i] in [0, 1) of 24 random bits;
+	// the same numbers as get(0, 2^24 - 1) / 2^24 in a row
+	virtual void fill(float* values, std::size_t count) {
+		for (std::size_t i = 0; i < count; ++i)
+			values[i] = (float)get(0, (1u << 24) - 1) * (1.f / (1u << 24));
+	}
+
 	virtual ~Randomizer() noexcept {}
 
 };
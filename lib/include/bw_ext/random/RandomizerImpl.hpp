@@ -22,27 +22,42 @@
 // SOFTWARE.
 //
 ////////////////////////////////////////////////////////////
-
 #ifndef RANDOMIZER_IMPL_HPP
 #define RANDOMIZER_IMPL_HPP
 #include "Randomizer.hpp"
-#include <random>
+#include <array>
+#include <cstddef>
 
 namespace Bulletworm {
 
-// independent
+// xoshiro256** with Lemire's bounded sampling: 32 bytes of state,
+// the same numbers with every compiler and standard library (the replays rely on it)
 class RandomizerImpl : public Randomizer {
 public:
 
-	RandomizerImpl();
+	RandomizerImpl() noexcept;
+
+	explicit RandomizerImpl(std::uint64_t seed) noexcept;
 
-	void setSeed(std::uint64_t seed);
+	void setSeed(std::uint64_t seed) noexcept;
 
 	[[nodiscard]] virtual std::uint64_t get(std::uint64_t least, std::uint64_t greatest) override;
 
+	// No virtual call per number, the rejection threshold is computed once
+	virtual void fill(std::uint64_t* values, std::size_t count, std::uint64_t bound) override;
+	virtual void fill(float* values, std::size_t count) override;
+
+	// Another reproducible stream derived from the state and the ID, this one doesn't change
+	[[nodiscard]] RandomizerImpl split(std::uint64_t streamId) const noexcept;
+
+	// streams[i] = RandomizerImpl(seed).split(i)
+	static void seedStreams(std::uint64_t seed, RandomizerImpl* streams, std::size_t count) noexcept;
+
 private:
 
-	std::mt19937_64 m_gen;
+	std::uint64_t next() noexcept;
+
+	std::array<std::uint64_t, 4> m_state{};
 };
 
 } // namespace Bulletworm
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef MAPPED_FILE_INPUT_STREAM_HPP
+#define MAPPED_FILE_INPUT_STREAM_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include "../MappedFile.hpp"
+#include <SFML/System/InputStream.hpp>
+#include <cstdint>
+
+namespace Bulletworm {
+
+////////////////////////////////////////////////////////////
+// Input file stream over a read-only mapping
+// (the read-side counterpart of FileOutputStream).
+// Nothing is read before the bytes are needed;
+// view() gives them without copying.
+////////////////////////////////////////////////////////////
+class MappedFileInputStream : public sf::InputStream {
+public:
+
+    // Creates no stream (call open() to use)
+    MappedFileInputStream() noexcept = default;
+
+    // Deleted copying ctor
+    MappedFileInputStream(const MappedFileInputStream&) = delete;
+
+    // Deleted copying =
+    MappedFileInputStream& operator=(const MappedFileInputStream&) = delete;
+
+    // Moving ctor
+    MappedFileInputStream(MappedFileInputStream&& src) noexcept;
+
+    // Moving =
+    MappedFileInputStream& operator=(MappedFileInputStream&& src) noexcept;
+
+    // Returns true if succeed, otherwise false (an empty file can't be mapped)
+    [[nodiscard]] bool open(const std::filesystem::path& filename) noexcept;
+
+    // Returns the actual count of read bytes.
+    // Param size in bytes
+    sf::Int64 read(void* data, sf::Int64 size) override;
+
+    // Returns -1 if error occured, otherwise the actual sought position
+    // All is in bytes
+    sf::Int64 seek(sf::Int64 position) override;
+
+    // Returns -1 if error occured, otherwise the told position (in bytes)
+    sf::Int64 tell() override;
+
+    // Returns -1 if error occured, otherwise the size of the stream in bytes
+    sf::Int64 getSize() override;
+
+    // Returns the next size bytes in place and moves past them,
+    // nullptr (and no move) if fewer are left.
+    // Valid until the stream is closed or reopened
+    const void* view(sf::Int64 size) noexcept;
+
+private:
+
+    MappedFile m_file;
+    sf::Int64 m_offset = 0;
+};
+
+} // namespace Bulletworm
+
+#endif // MAPPED_FILE_INPUT_STREAM_HPP
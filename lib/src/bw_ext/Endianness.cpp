@@ -22,17 +22,41 @@
 // SOFTWARE.
 //
 ////////////////////////////////////////////////////////////
-
 #include <bw_ext/Endianness.hpp>
-#include <SFML/Config.hpp>
+#include <bw_ext/stream/MappedFileInputStream.hpp>
+#include <SFML/System/InputStream.hpp>
+#include <algorithm>
+#include <cstring>
 
-#if defined(SFML_SYSTEM_WINDOWS)
+#if defined(_WIN32)
 #include <WinSock2.h>
 #else
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #endif
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BULLETWORM_SWAP_SSSE3
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define BULLETWORM_SWAP_SSSE3
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BULLETWORM_SWAP_SSE2
+#endif
+
+namespace {
+
+// values per read of readN2hl (64 KiB)
+constexpr std::size_t ReadBlockSize = 1 << 14;
+
+std::uint32_t swapBytes(std::uint32_t v) noexcept {
+    return (v >> 24) | ((v >> 8) & 0xff00u) | ((v << 8) & 0xff0000u) | (v << 24);
+}
+
+}
+
 namespace Bulletworm {
 
 // WHEN LOADING
@@ -45,4 +69,95 @@ std::uint32_t h2nl(std::uint32_t host) {
     return htonl(host);
 }
 
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void swapByteOrder(const std::uint32_t* source, std::uint32_t* destination, std::size_t count) noexcept {
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i shuffle256 = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_shuffle_epi8(v, shuffle256));
+    }
+#endif
+
+#if defined(BULLETWORM_SWAP_SSSE3)
+    const __m128i shuffle = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_shuffle_epi8(v, shuffle));
+    }
+#elif defined(BULLETWORM_SWAP_SSE2)
+    // the bytes of the 16-bit halves, then the halves
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), v);
+    }
+#endif
+
+    for (; i < count; ++i)
+        destination[i] = swapBytes(source[i]);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void n2hl(const std::uint32_t* network, std::uint32_t* host, std::size_t count) noexcept {
+    h2nl(network, host, count);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void h2nl(const std::uint32_t* host, std::uint32_t* network, std::size_t count) noexcept {
+#if BULLETWORM_BIG_ENDIAN
+    if (host != network && count)
+        std::memcpy(network, host, count * sizeof(std::uint32_t));
+#else
+    swapByteOrder(host, network, count);
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+bool readN2hl(sf::InputStream& stream, std::uint32_t* values, std::size_t count,
+              bool endiannessRequired) {
+    if (auto* mapped = dynamic_cast<MappedFileInputStream*>(&stream)) {
+        std::int64_t position = mapped->tell();
+        const void* source = mapped->view((std::int64_t)(count * sizeof(std::uint32_t)));
+        if (!source)
+            return false;
+
+        if (reinterpret_cast<std::uintptr_t>(source) % alignof(std::uint32_t) == 0) {
+            if (endiannessRequired)
+                n2hl(static_cast<const std::uint32_t*>(source), values, count);
+            else if (count)
+                std::memcpy(values, source, count * sizeof(std::uint32_t));
+
+            return true;
+        }
+
+        // unaligned values, the generic way
+        mapped->seek(position);
+    }
+
+    for (std::size_t first = 0; first < count; first += ReadBlockSize) {
+        std::size_t blockSize = std::min(ReadBlockSize, count - first);
+        std::int64_t byteSize = (std::int64_t)(blockSize * sizeof(std::uint32_t));
+
+        if (stream.read(values + first, byteSize) != byteSize)
+            return false;
+
+        if (endiannessRequired)
+            n2hl(values + first, blockSize);
+    }
+
+    return true;
+}
+
 }
@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+#include <bw_ext/MappedFile.hpp>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Bulletworm {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+MappedFile::~MappedFile() noexcept {
+	close();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+MappedFile::MappedFile(MappedFile&& src) noexcept :
+	m_data(src.m_data),
+	m_size(src.m_size) {
+	src.m_data = nullptr;
+	src.m_size = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+MappedFile& MappedFile::operator=(MappedFile&& src) noexcept {
+	if (this == &src)
+		return *this;
+
+	close();
+
+	m_data = src.m_data;
+	m_size = src.m_size;
+
+	src.m_data = nullptr;
+	src.m_size = 0;
+
+	return *this;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+bool MappedFile::open(const std::filesystem::path& filename) noexcept {
+	close();
+
+#if defined(_WIN32)
+
+	HANDLE file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+							  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(file, &size) || !size.QuadPart) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping)
+		return false;
+
+	// the view keeps the mapping alive
+	const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!data)
+		return false;
+
+	m_data = data;
+	m_size = (std::size_t)size.QuadPart;
+
+#else
+
+	int file = ::open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat status {};
+	if (fstat(file, &status) || status.st_size <= 0) {
+		::close(file);
+		return false;
+	}
+
+	// the mapping keeps the file alive
+	void* data = mmap(nullptr, (std::size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	::close(file);
+	if (data == MAP_FAILED)
+		return false;
+
+	m_data = data;
+	m_size = (std::size_t)status.st_size;
+
+#endif
+
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void MappedFile::close() noexcept {
+	if (!m_data)
+		return;
+
+#if defined(_WIN32)
+	UnmapViewOfFile(m_data);
+#else
+	munmap(const_cast<void*>(m_data), m_size);
+#endif
+
+	m_data = nullptr;
+	m_size = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void MappedFile::adviseSequential() const noexcept {
+	if (!m_data)
+		return;
+
+#if !defined(_WIN32)
+	// only a hint, the failure changes nothing
+	(void)madvise(const_cast<void*>(m_data), m_size, MADV_SEQUENTIAL);
+#endif
+}
+
+} // namespace Bulletworm
@@ -31,10 +31,15 @@ namespace Bulletworm {
 ParticleSystem::ParticleSystem() noexcept {}
 ParticleSystem::ParticleSystem(std::size_t count) :
 	m_particles(count),
-	m_vertices(count * 3) {}
+	m_vertices(count * 3),
+	m_randoms(count * RandomsPerParticle) {}
 void ParticleSystem::init(std::size_t count) {
 	m_particles.resize(count);
 	m_vertices.resize(count * 3);
+	m_randoms.resize(count * RandomsPerParticle);
+}
+void ParticleSystem::setSeed(std::uint64_t seed) noexcept {
+	m_randomizer.setSeed(seed);
 }
 void ParticleSystem::update(sf::Time elapsed) noexcept {
 	for (std::size_t i = 0; i < m_particles.size(); ++i) {
@@ -76,32 +81,43 @@ void ParticleSystem::awake(float particleRadius,
 						   float maxVelocity) {
 	constexpr float pi = 3.141592654f;
 
-	for (std::size_t i = 0; i < std::min(count, m_particles.size()); ++i) {
+	count = std::min(count, m_particles.size());
+
+	// one call for the whole burst instead of the locking std::rand per number
+	m_randomizer.fill(m_randoms.data(), count * RandomsPerParticle);
+
+	for (std::size_t i = 0; i < count; ++i) {
 		Particle& p = m_particles[i];
-		float angle = (float)std::rand() / RAND_MAX * pi * 2;
-		int speedSelection = std::rand();
-		float speed = minVelocity + (maxVelocity - minVelocity) * speedSelection / RAND_MAX;
-		p.velocity = sf::Vector2f(std::cos(angle) * speed, std::sin(angle) * speed);
+		const float* randoms = m_randoms.data() + i * RandomsPerParticle;
+
+		float angle = randoms[0] * pi * 2;
+		float angleCos = std::cos(angle);
+		float angleSin = std::sin(angle);
+
+		float speed = minVelocity + (maxVelocity - minVelocity) * randoms[1];
+		p.velocity = sf::Vector2f(angleCos * speed, angleSin * speed);
 
-		p.acceleration = sf::Vector2f(std::cos(angle) * acceleration, std::sin(angle) * acceleration);
+		p.acceleration = sf::Vector2f(angleCos * acceleration, angleSin * acceleration);
 
-		int lifetimeSelection = std::rand();
-		sf::Time lifetime = minLifetime + (maxLifetime - minLifetime) * ((float)lifetimeSelection / RAND_MAX);
+		sf::Time lifetime = minLifetime + (maxLifetime - minLifetime) * randoms[2];
 		p.lifetime = p.constLifetime = lifetime;
 
-		int distanceSelection = std::rand();
-		float distance = minDistance + (maxDistance - minDistance) * distanceSelection / RAND_MAX;
-		sf::Vector2f rcpos = centralPosition + sf::Vector2f(std::cos(angle) * distance, std::sin(angle) * distance);
+		float distance = minDistance + (maxDistance - minDistance) * randoms[3];
+		sf::Vector2f rcpos = centralPosition + sf::Vector2f(angleCos * distance, angleSin * distance);
 
-		constexpr float second3angle = pi * 2 / 3;
-		constexpr float third3angle = pi * 4 / 3;
-		float rotation = (float)std::rand() / RAND_MAX * second3angle;
+		// the other two vertices are the first one rotated by 120 and 240 degrees
+		constexpr float third3Cos = -0.5f;
+		constexpr float third3Sin = 0.866025404f;
+		float rotation = randoms[4] * pi * 2 / 3;
+		sf::Vector2f first(std::cos(rotation), std::sin(rotation));
+		sf::Vector2f second(first.x * third3Cos - first.y * third3Sin, first.x * third3Sin + first.y * third3Cos);
+		sf::Vector2f third(first.x * third3Cos + first.y * third3Sin, first.y * third3Cos - first.x * third3Sin);
 
-		m_vertices[0 + i * 3].position = rcpos + particleRadius * sf::Vector2f(std::cos(rotation), std::sin(rotation));
-		m_vertices[1 + i * 3].position = rcpos + particleRadius * sf::Vector2f(std::cos(rotation + second3angle), std::sin(rotation + second3angle));
-		m_vertices[2 + i * 3].position = rcpos + particleRadius * sf::Vector2f(std::cos(rotation + third3angle), std::sin(rotation + third3angle));
+		m_vertices[0 + i * 3].position = rcpos + particleRadius * first;
+		m_vertices[1 + i * 3].position = rcpos + particleRadius * second;
+		m_vertices[2 + i * 3].position = rcpos + particleRadius * third;
 
-		float colorSelection = (float)std::rand() / RAND_MAX;
+		float colorSelection = randoms[5];
 		if (colorSelection < secondColorRatio)
 			m_vertices[0 + i * 3].color = m_vertices[1 + i * 3].color = m_vertices[2 + i * 3].color = (sf::Color)secondColor;
 		else
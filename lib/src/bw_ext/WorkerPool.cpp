@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+#include <bw_ext/WorkerPool.hpp>
+#include <algorithm>
+#include <atomic>
+
+namespace Bulletworm {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+WorkerPool::WorkerPool(unsigned int threadCount) {
+	if (!threadCount)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	m_threads.reserve(threadCount);
+	for (unsigned int i = 0; i < threadCount; ++i)
+		m_threads.emplace_back(&WorkerPool::work, this, i);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+
+	m_wake.notify_all();
+
+	for (auto& thread : m_threads)
+		thread.join();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void WorkerPool::run(const std::function<void(unsigned int)>& job) {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_job = &job;
+	m_busyCount = (unsigned int)m_threads.size();
+	++m_generation;
+	m_wake.notify_all();
+	m_done.wait(lock, [this] { return m_busyCount == 0; });
+	m_job = nullptr;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void WorkerPool::runTasks(std::size_t taskCount, const std::function<void(std::size_t)>& task) {
+	std::atomic<std::size_t> nextTask{ 0 };
+
+	run([&](unsigned int) {
+		for (std::size_t index = nextTask++; index < taskCount; index = nextTask++)
+			task(index);
+	});
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void WorkerPool::work(unsigned int index) {
+	std::uint64_t generation = 0;
+
+	for (;;) {
+		const std::function<void(unsigned int)>* job;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [this, generation] { return m_stop || m_generation != generation; });
+			if (m_stop)
+				return;
+
+			generation = m_generation;
+			job = m_job;
+		}
+
+		(*job)(index);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (--m_busyCount == 0)
+			m_done.notify_one();
+	}
+}
+
+} // namespace Bulletworm
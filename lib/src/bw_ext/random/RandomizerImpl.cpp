@@ -22,22 +22,157 @@
 // SOFTWARE.
 //
 ////////////////////////////////////////////////////////////
-
 #include <bw_ext/random/RandomizerImpl.hpp>
+#include <cassert>
+
+#if !defined(__SIZEOF_INT128__) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace {
+
+constexpr std::uint64_t rotl(std::uint64_t x, int k) noexcept {
+    return (x << k) | (x >> (64 - k));
+}
+
+std::uint64_t splitMix64(std::uint64_t& state) noexcept {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// (high, low) halves of the 128-bit product
+std::uint64_t multiply(std::uint64_t a, std::uint64_t b, std::uint64_t& low) noexcept {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)a * b;
+    low = (std::uint64_t)product;
+    return (std::uint64_t)(product >> 64);
+#elif defined(_M_X64)
+    std::uint64_t high;
+    low = _umul128(a, b, &high);
+    return high;
+#else
+    std::uint64_t aLow = a & 0xffffffffull, aHigh = a >> 32;
+    std::uint64_t bLow = b & 0xffffffffull, bHigh = b >> 32;
+    std::uint64_t lowLow = aLow * bLow;
+    std::uint64_t highLow = aHigh * bLow;
+    std::uint64_t lowHigh = aLow * bHigh;
+    std::uint64_t middle = (lowLow >> 32) + (highLow & 0xffffffffull) + lowHigh;
+    low = (middle << 32) | (lowLow & 0xffffffffull);
+    return aHigh * bHigh + (highLow >> 32) + (middle >> 32);
+#endif
+}
+
+}
 
 namespace Bulletworm {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-RandomizerImpl::RandomizerImpl() {}
+RandomizerImpl::RandomizerImpl() noexcept {
+    setSeed(0);
+}
+
 
-void RandomizerImpl::setSeed(std::uint64_t seed) {
-    m_gen.seed(seed);
-    m_gen.discard(3);
+RandomizerImpl::RandomizerImpl(std::uint64_t seed) noexcept {
+    setSeed(seed);
 }
 
+
+void RandomizerImpl::setSeed(std::uint64_t seed) noexcept {
+    // never all zeros
+    for (std::uint64_t& word : m_state)
+        word = splitMix64(seed);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
 std::uint64_t RandomizerImpl::get(std::uint64_t least, std::uint64_t greatest) {
-    std::uniform_int_distribution<std::uint64_t> distr(least, greatest);
-    return distr(m_gen);
+    assert(least <= greatest);
+
+    std::uint64_t range = greatest - least + 1;
+
+    // the full range
+    if (!range)
+        return next();
+
+    // Lemire: the high half of x * range, rejecting the biased low halves
+    std::uint64_t low;
+    std::uint64_t high = multiply(next(), range, low);
+
+    if (low < range) {
+        std::uint64_t threshold = (0 - range) % range;
+
+        while (low < threshold)
+            high = multiply(next(), range, low);
+    }
+
+    return least + high;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void RandomizerImpl::fill(std::uint64_t* values, std::size_t count, std::uint64_t bound) {
+    if (!bound) {
+        for (std::size_t i = 0; i < count; ++i)
+            values[i] = next();
+        return;
+    }
+
+    // below it the same as in get: the rejected low halves are less than the threshold
+    std::uint64_t threshold = (0 - bound) % bound;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t low;
+        std::uint64_t high = multiply(next(), bound, low);
+
+        while (low < threshold)
+            high = multiply(next(), bound, low);
+
+        values[i] = high;
+    }
+}
+
+
+void RandomizerImpl::fill(float* values, std::size_t count) {
+    // the high 24 bits, no rejection for a power of two
+    for (std::size_t i = 0; i < count; ++i)
+        values[i] = (float)(next() >> 40) * (1.f / (1u << 24));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+RandomizerImpl RandomizerImpl::split(std::uint64_t streamId) const noexcept {
+    std::uint64_t mixer = streamId;
+    std::uint64_t seed = m_state[0] ^ rotl(m_state[1], 17) ^ rotl(m_state[2], 31) ^
+        rotl(m_state[3], 47) ^ splitMix64(mixer);
+
+    return RandomizerImpl(seed);
+}
+
+
+void RandomizerImpl::seedStreams(std::uint64_t seed, RandomizerImpl* streams, std::size_t count) noexcept {
+    RandomizerImpl root(seed);
+
+    for (std::size_t i = 0; i < count; ++i)
+        streams[i] = root.split(i);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+std::uint64_t RandomizerImpl::next() noexcept {
+    std::uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+    std::uint64_t shifted = m_state[1] << 17;
+
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+
+    m_state[2] ^= shifted;
+    m_state[3] = rotl(m_state[3], 45);
+
+    return result;
 }
 
 }
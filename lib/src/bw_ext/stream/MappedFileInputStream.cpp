@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <bw_ext/stream/MappedFileInputStream.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace Bulletworm {
+
+////////////////////////////////////////////////////////////
+MappedFileInputStream::MappedFileInputStream(MappedFileInputStream&& src) noexcept :
+    m_file(std::move(src.m_file)),
+    m_offset(src.m_offset) {
+    src.m_offset = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+MappedFileInputStream& MappedFileInputStream::operator=(MappedFileInputStream&& src) noexcept {
+    if (this == &src)
+        return *this;
+
+    m_file = std::move(src.m_file);
+    m_offset = src.m_offset;
+    src.m_offset = 0;
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+bool MappedFileInputStream::open(const std::filesystem::path& filename) noexcept {
+    m_offset = 0;
+
+    if (!m_file.open(filename))
+        return false;
+
+    // the loaders go front to back
+    m_file.adviseSequential();
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Int64 MappedFileInputStream::read(void* data, sf::Int64 size) {
+    if (!m_file.isOpen())
+        return -1;
+
+    sf::Int64 count = std::min(size, getSize() - m_offset);
+    if (count <= 0)
+        return 0;
+
+    std::memcpy(data, static_cast<const char*>(m_file.getData()) + m_offset, (std::size_t)count);
+    m_offset += count;
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Int64 MappedFileInputStream::seek(sf::Int64 position) {
+    if (!m_file.isOpen())
+        return -1;
+
+    m_offset = std::clamp(position, (sf::Int64)0, getSize());
+    return m_offset;
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Int64 MappedFileInputStream::tell() {
+    if (!m_file.isOpen())
+        return -1;
+
+    return m_offset;
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Int64 MappedFileInputStream::getSize() {
+    if (!m_file.isOpen())
+        return -1;
+
+    return (sf::Int64)m_file.getSize();
+}
+
+
+////////////////////////////////////////////////////////////
+const void* MappedFileInputStream::view(sf::Int64 size) noexcept {
+    if (!m_file.isOpen() || size < 0 || size > (sf::Int64)m_file.getSize() - m_offset)
+        return nullptr;
+
+    const void* data = static_cast<const char*>(m_file.getData()) + m_offset;
+    m_offset += size;
+    return data;
+}
+
+} // namespace Bulletworm
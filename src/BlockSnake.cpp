@@ -28,7 +28,6 @@
 #include "BlockSnake.hpp"
 #include <SFML/Config.hpp>
 #include <SFML/Graphics/Texture.hpp>
-#include <bw_ext/FenwickTree.hpp>
 #include "TextureLoader.hpp"
 #include "Constants.hpp"
 #include <bw_ext/Endianness.hpp>
@@ -46,6 +45,7 @@
 #include <SFML/System/MemoryInputStream.hpp>
 #include <SFML/Graphics/Text.hpp>
 #include <bw_ext/stream/MemoryOutputStream.hpp>
+#include <bw_ext/stream/MappedFileInputStream.hpp>
 #include <SFML/Audio/Listener.hpp>
 #include <SFML/Window/Event.hpp>
 #include <SFML/Window/Clipboard.hpp>
@@ -55,33 +55,9 @@
 #include <iostream>
 #include <filesystem>
 #include <cstring>
-
-namespace {
-
-void fwkCreate(std::vector<std::uintmax_t>& vec, const std::uint32_t* values,
-               std::size_t sz) {
-    using fwt = Bulletworm::FenwickTree<std::vector<std::uintmax_t>::iterator,
-        std::vector<std::uintmax_t>::const_iterator, std::ptrdiff_t, std::uintmax_t>;
-
-    constexpr auto realsize = [](std::size_t val) {
-        unsigned int bitlog = 0;
-        std::size_t tval = (val ? (val - 1) : 0);
-        while (tval) {
-            tval >>= 1;
-            ++bitlog;
-        }
-        return (std::size_t)1 + (val ? (((std::size_t)1u) << bitlog) : 0);
-    };
-
-    vec.resize(realsize(sz));
-
-    std::copy(values, values + sz, vec.data() + 1);
-    std::fill(vec.data() + sz + 1, vec.data() + vec.size(), 0);
-    vec[0] = 0;
-    fwt::init(vec.begin(), vec.end());
-}
-
-}
+#include <array>
+#include <limits>
+#include <random>
 
 namespace Bulletworm {
 
@@ -206,7 +182,7 @@ bool BlockSnake::loadStatus() {
         std::vector<std::uint32_t> dataInput;
 
         // decryption
-        sf::FileInputStream finp;
+        MappedFileInputStream finp;
         if (!finp.open((std::string)pwd + STATUS_PATH)) {
             /*m_logger << "Failed to open status.bin\n";
             return false;*/
@@ -256,18 +232,13 @@ bool BlockSnake::loadStatus() {
         // 4 as uint32 * 4 is encryption redundancy factor
         dataInputDecrypted.resize(sz / 16, 0);
         dataInput.resize(sz / 4);
-        sf::Int64 read = finp.read(dataInput.data(), sz);
-        if (read != sz) {
+
+        // endianness while reading
+        if (!readN2hl(finp, dataInput.data(), dataInput.size())) {
             m_logger << "Failed to read status.bin\n";
             return false;
         }
 
-        // endianness
-        std::for_each(dataInput.begin(), dataInput.end(),
-                      [](std::uint32_t& v) {
-                          v = n2hl(v);
-                      });
-
         static const std::uint64_t decrMatrix[]{
             53159 ,25843  ,9021 ,20417 ,31113 ,12430 ,26622, 64479,
      1257, 56731, 12394 ,55339 ,36655 , 7528, 27389, 58154,
@@ -365,35 +336,21 @@ bool BlockSnake::loadStatus() {
 
 bool BlockSnake::loadData() {
 
-    std::vector<std::uint32_t> dataInput;
+    // kept: the levels decode their count maps from it on demand
+    MappedFileInputStream& minp = m_dataStream;
 
     {
         // checksum
-        sf::FileInputStream finp;
-        if (!finp.open((std::string)pwd + DATA_PATH)) {
+        if (!minp.open((std::string)pwd + DATA_PATH)) {
             m_logger << "Failed to load " << (std::string)pwd + DATA_PATH << "\n";
             return false;
         }
 
-        sf::Int64 sz = finp.getSize();
-        if (sz % 4 != 0) {
+        if (minp.getSize() % 4 != 0) {
             m_logger << "data.bin: wrong size\n";
             return false;
         }
 
-        dataInput.resize(sz / 4);
-        sf::Int64 read = finp.read(dataInput.data(), sz);
-        if (read != sz) {
-            m_logger << "Failed to read data.bin\n";
-            return false;
-        }
-
-        // endianness
-        std::for_each(dataInput.begin(), dataInput.end(),
-                      [](std::uint32_t& v) {
-                          v = n2hl(v);
-                      });
-
         bool pass = true;
 
         if (!pass) {
@@ -406,73 +363,38 @@ bool BlockSnake::loadData() {
         }
     }
 
-    sf::MemoryInputStream minp;
-    minp.open(dataInput.data(), dataInput.size() * 4);
-
+    // the sections are converted straight from the mapping
     // COLORS
-    sf::Int64 ctntread = minp.read(m_colors.data(),
-                                      (sf::Int64)sizeof(std::uint32_t) * ColorDstCount);
-    if (ctntread != (sf::Int64)sizeof(std::uint32_t) * ColorDstCount)
+    if (!readN2hl(minp, m_colors.data(), m_colors.size()))
         return false;
 
-    // endianness
-    /*std::for_each(m_colors.begin(), m_colors.end(),
-                  [](std::uint32_t& v) {
-                      v = n2hl(v);
-                  });*/
-
     // BEHAVIOR
-    auto objlog{ ObjectBehaviorLoader::loadFromStream(m_objectBehaviors, minp, false) };
+    auto objlog{ ObjectBehaviorLoader::loadFromStream(m_objectBehaviors, minp, true) };
     if (objlog) {
         m_logger << *objlog;
         return false;
     }
 
     // BEHAVIOR MAP
-    ctntread = minp.read(m_objectPreEffects.data(),
-                         (sf::Int64)sizeof(std::uint32_t) * m_objectPreEffects.size());
-    if (ctntread != (sf::Int64)sizeof(std::uint32_t) *
-        (sf::Int64)m_objectPreEffects.size())
+    if (!readN2hl(minp, m_objectPreEffects.data(), m_objectPreEffects.size()))
         return false;
 
-    // endianness
-    /*std::for_each(m_objectPreEffects.begin(), m_objectPreEffects.end(),
-                  [](std::uint32_t& v) {
-                      v = n2hl(v);
-                  });*/
-
-    ctntread = minp.read(m_objectPostEffects.data(),
-                         (sf::Int64)sizeof(std::uint32_t) * m_objectPostEffects.size());
-
-    if (ctntread != (sf::Int64)sizeof(std::uint32_t) *
-        (sf::Int64)m_objectPostEffects.size())
+    if (!readN2hl(minp, m_objectPostEffects.data(), m_objectPostEffects.size()))
         return false;
 
-    // endianness
-    /*std::for_each(m_objectPostEffects.begin(), m_objectPostEffects.end(),
-                  [](std::uint32_t& v) {
-                      v = n2hl(v);
-                  });*/
-
-    ctntread = minp.read(m_objectTailCapacities1.data(),
-                         (sf::Int64)sizeof(std::uint32_t) * m_objectTailCapacities1.size());
-    if (ctntread != (sf::Int64)sizeof(std::uint32_t) *
-        (sf::Int64)m_objectTailCapacities1.size())
+    if (!readN2hl(minp, m_objectTailCapacities1.data(), m_objectTailCapacities1.size()))
         return false;
 
-    // endianness
-    /*std::for_each(m_objectTailCapacities1.begin(), m_objectTailCapacities1.end(),
-                  [](std::uint32_t& v) {
-                      v = n2hl(v);
-                  });*/
-
     unsigned int diffCount = m_levelStatistics.getDifficultyCount();
     unsigned int levelCount = m_levelStatistics.getLevelCount();
 
     // LEVELS
-    if (!m_levels.loadFromStream(diffCount, levelCount, minp, false))
+    if (!m_levels.loadFromStream(diffCount, levelCount, minp, true))
         return false;
 
+    // prepared levels are mapped from there on the later starts
+    m_levelPreparation.setCacheDirectory((std::string)pwd + LEVEL_CACHE_PATH);
+
     return true;
 }
 
@@ -702,6 +624,7 @@ bool BlockSnake::start() {
 
     // std::rand is used for effects, so pure randomness is unneccessary
     std::srand((unsigned int)std::time(NULL));
+    m_gameDrawable.particles.setSeed((std::uint64_t)std::time(NULL));
 
     // setup the shaders with the texture
 
@@ -803,10 +726,7 @@ bool BlockSnake::saveStatusSub() const {
     }
 
     // endianness
-    std::for_each(dataOutputRedundant.begin(), dataOutputRedundant.end(),
-                  [](std::uint32_t& v) {
-                      v = h2nl(v);
-                  });
+    h2nl(dataOutputRedundant.data(), dataOutputRedundant.size());
 
     FileOutputStream foutp;
 
@@ -1051,7 +971,10 @@ bool BlockSnake::playGame() {
     m_toReturn = true;
     m_gameAgain = true;
 
-    prepareGame();
+    if (!prepareGame()) {
+        wallpaperChanging.join(); // !
+        return false;
+    }
 
     bool wallpaperChangingJoined = false;
 
@@ -1059,7 +982,12 @@ bool BlockSnake::playGame() {
     {
         m_levelComplete = false;
 
+        // a fresh seed per game, the replay reproduces it
+        std::uint64_t gameSeed = m_randomizer.get(0, std::numeric_limits<std::uint64_t>::max());
+        RandomizerImpl::seedStreams(gameSeed, m_gameRandomizers.data(), m_gameRandomizers.size());
+
         m_game.restart(m_initialObjectMemory.data());
+        m_replayRecorder.start(gameSeed, m_difficulty, m_levelIndex);
         playGameMusic();
 
         sf::Listener::setPosition((float)m_game.getImpl()
@@ -1111,11 +1039,14 @@ bool BlockSnake::playGame() {
             processEvents();
 
             m_game.update(m_nowTime);
+            m_replayRecorder.recordUpdate(m_game);
             processGameEvents();
             scaleUpdate();
             drawWindow();
         }
 
+        m_replayRecorder.finish(m_game);
+        saveReplay();
         endGame();
 
     } while (m_gameAgain);
@@ -1225,64 +1156,32 @@ void BlockSnake::createChallVisual() {
 }
 
 
-void BlockSnake::prepareGame() {
+bool BlockSnake::prepareGame() {
   // Some links
 
     GameImpl::LevelPointers levelPtrs;
-    levelPtrs.attribArray = m_levels.getLevelAttribPtr(m_difficulty, m_levelIndex);
-    levelPtrs.effectDurations = m_levels.getEffectDurationPtr(m_difficulty, m_levelIndex);
-    levelPtrs.powerupProbs = &m_levels.getPowerupProbs(m_difficulty, m_levelIndex);
-
     levelPtrs.objectBehs = m_objectBehaviors.data();
     levelPtrs.postEffectBehIndices = m_objectPostEffects.data();
     levelPtrs.preEffectBehIndices = m_objectPreEffects.data();
     levelPtrs.tailCapacities1 = m_objectTailCapacities1.data();
 
-    const sf::Vector2u& mapSize = m_levels.getMapSize(m_difficulty, m_levelIndex);
-    std::size_t area{ (std::size_t)mapSize.x * mapSize.y };
-
-    m_currentObjPairIndices.resize(area);
-    m_currentObjParams.resize(area);
-    m_currentThemes.resize(area);
-
-    std::vector<std::uint32_t> forProbs(area);
-
-    auto cmfunc = [&area](std::vector<std::uint32_t>& vect, const std::uint32_t* cm) {
-        std::size_t cmi = 0;
-        for (std::size_t ii = 0; cmi < area; ii += 2) {
-            std::uint32_t what = cm[ii + 1];
-            for (std::uint32_t j = 0; j < cm[ii]; ++j, ++cmi)
-                vect[cmi] = what;
-        }
-    };
-
-    m_initialObjectMemory.resize(area);
-
-    cmfunc(m_currentThemes, m_levels.getLevelCountMap(LevelCountMap::Theme,
-           m_difficulty, m_levelIndex));
-    cmfunc(m_currentObjPairIndices, m_levels.getLevelCountMap(LevelCountMap::ObjPair,
-           m_difficulty, m_levelIndex));
-    cmfunc(m_currentObjParams, m_levels.getLevelCountMap(LevelCountMap::Param,
-           m_difficulty, m_levelIndex));
-    cmfunc(m_initialObjectMemory, m_levels.getLevelCountMap(LevelCountMap::Memory,
-           m_difficulty, m_levelIndex));
-    cmfunc(forProbs, m_levels.getLevelCountMap(LevelCountMap::SnakeStartPos,
-           m_difficulty, m_levelIndex));
-
-    fwkCreate(m_currentSnakePosProbs, forProbs.data(), forProbs.size());
-
-    for (int i = 0; i < ItemCount; ++i) {
-        cmfunc(forProbs, m_levels.getItemProbCountMap(EatableItem(i),
-               m_difficulty, m_levelIndex));
-        m_currentItemProbabilities[i].create(mapSize, forProbs.data());
+    LevelPreparation::Destination destination;
+    destination.objectMemory = &m_initialObjectMemory;
+    destination.snakePositionProbs = &m_currentSnakePosProbs;
+    destination.itemProbabilities = m_currentItemProbabilities.data();
+    destination.cells = &m_currentCells;
+
+    // updateUnits walks the visible zone column by column
+    if (!m_levelPreparation.prepare(m_levels, m_difficulty, m_levelIndex, true, GridLayout::Tiled,
+                                    destination, levelPtrs)) {
+        m_logger << "data.bin: level " << m_levelIndex << " of difficulty " << m_difficulty
+            << " is corrupted\n";
+        return false;
     }
 
-    levelPtrs.objectPairIndices = m_currentObjPairIndices.data();
-    levelPtrs.objectParams = m_currentObjParams.data();
-    levelPtrs.snakePositionProbs = &m_currentSnakePosProbs;
-
     std::array<Randomizer*, RandomTypeCount> allRands{};
-    allRands.fill(&m_randomizer);
+    for (int i = 0; i < RandomTypeCount; ++i)
+        allRands[i] = &m_gameRandomizers[i];
 
     std::array<const Map<std::uint32_t>*, ItemCount> itemProbPtrs{};
     std::transform(m_currentItemProbabilities.begin(),
@@ -1292,6 +1191,8 @@ void BlockSnake::prepareGame() {
 
     m_game.restart(
         GameImpl{ levelPtrs, allRands.data(), m_initialObjectMemory.data(), itemProbPtrs.data() });
+
+    return true;
 }
 
 
@@ -1466,8 +1367,6 @@ bool BlockSnake::isCameraStopped() const {
 
 
 void BlockSnake::updateUnits() {
-    const sf::Vector2u& mapSize = m_levels.getMapSize(m_difficulty, m_levelIndex);
-
     sf::IntRect innerZone = getInnerVisibleZone();
     sf::Vector2i leftTopInMap(innerZone.left, innerZone.top);
     sf::Vector2i rightDownInMap = leftTopInMap +
@@ -1477,11 +1376,10 @@ void BlockSnake::updateUnits() {
         for (int y = leftTopInMap.y; y <= rightDownInMap.y; ++y) {
             sf::Vector2i currentInInnerView(x, y);
             currentInInnerView -= leftTopInMap;
-            ObjectPair theelem = (ObjectPair)m_game.getImpl()
-                .getLevelPointers().objectPairIndices[x + y * mapSize.x];
-            std::uint32_t theparam =
-                m_game.getImpl().getLevelPointers().objectParams[x + y * mapSize.x];
-            std::uint32_t thetheme = m_currentThemes[x + (std::size_t)y * mapSize.x];
+            const GameImpl::CellRecord& cell = m_currentCells.at(x, y);
+            ObjectPair theelem = (ObjectPair)cell.objectPair;
+            std::uint32_t theparam = cell.objectParam;
+            std::uint32_t thetheme = cell.theme;
 
             using Orn = Orientation;
             using Txut = TextureUnit;
@@ -2133,7 +2031,7 @@ void BlockSnake::drawWindow() {
         } else {
             if (m_snakeTailEndVisible && innerZone.contains(backPosition) &&
                 !snakeWorld.getTailIDs(backPosition).empty()) {
-                Direction theSecondEndDir = snakeWorld.getTailIDs(backPosition).begin()->second.tdexit;
+                Direction theSecondEndDir = snakeWorld.getTailIDs(backPosition).front().second.tdexit;
 
                 currentCirclePos = getPositionOfCircleExit(theSecondEndDir,
                                                            backPositionInViewBiased);
@@ -2145,7 +2043,7 @@ void BlockSnake::drawWindow() {
 
             if (m_snakeTailPreendVisible && innerZone.contains(frontEndPos) &&
                 !snakeWorld.getTailIDs(frontEndPos).empty()) {
-                const auto& taildir = snakeWorld.getTailIDs(frontEndPos).begin()->second;
+                const auto taildir = snakeWorld.getTailIDs(frontEndPos).front().second;
 
                 currentCirclePos = getPositionOfCircleEntry(taildir.tdentry,
                                                             frontEndInViewBiased);
@@ -2178,7 +2076,7 @@ void BlockSnake::drawWindow() {
             m_movingReserved = tmpMovingReserved;
 
             if (innerZone.contains(neckPosition) && !snakeWorld.getTailIDs(neckPosition).empty()) {
-                Direction neckEntryDir = snakeWorld.getTailIDs(neckPosition).begin()->second.tdentry;
+                Direction neckEntryDir = snakeWorld.getTailIDs(neckPosition).front().second.tdentry;
 
                 currentCirclePos = getPositionOfCircleEntry(neckEntryDir,
                                                             neckPositionInViewBiased);
@@ -2492,9 +2390,9 @@ void BlockSnake::updateItems(EatableItem item) {
     };
 
     if (item == EatableItem::Fruit || item == EatableItem::Bonus) {
-        const SnakeWorld::ItemSet& posset = ((item == EatableItem::Fruit) ?
-                                             snakeWorld.getFruitPositions() :
-                                             snakeWorld.getBonusPositions());
+        SnakeWorld::ItemPositions posset = ((item == EatableItem::Fruit) ?
+                                            snakeWorld.getFruitPositions() :
+                                            snakeWorld.getBonusPositions());
 
         for (const sf::Vector2i& now : posset) {
           // to view!!!
@@ -2805,23 +2703,23 @@ void BlockSnake::processEvents() {
             } else if (event.key.scancode == sf::Keyboard::Scancode::W ||
                         event.key.code == sf::Keyboard::Up ||
                        event.key.scancode == sf::Keyboard::Scancode::Numpad8) {
-                m_game.pushCommand(m_nowTime, Direction::Up);
+                pushGameCommand(Direction::Up);
                 m_rotatedPostEffect = false;
             } else if (event.key.scancode == sf::Keyboard::Scancode::A ||
                         event.key.code == sf::Keyboard::Left ||
                        event.key.scancode == sf::Keyboard::Scancode::Numpad4) {
-                m_game.pushCommand(m_nowTime, Direction::Left);
+                pushGameCommand(Direction::Left);
                 m_rotatedPostEffect = false;
             } else if (event.key.scancode == sf::Keyboard::Scancode::S ||
                         event.key.code == sf::Keyboard::Down ||
                        event.key.scancode == sf::Keyboard::Scancode::Numpad5 ||
                        event.key.scancode == sf::Keyboard::Scancode::Numpad2) {
-                m_game.pushCommand(m_nowTime, Direction::Down);
+                pushGameCommand(Direction::Down);
                 m_rotatedPostEffect = false;
             } else if (event.key.scancode == sf::Keyboard::Scancode::D ||
                         event.key.code == sf::Keyboard::Right ||
                        event.key.scancode == sf::Keyboard::Scancode::Numpad6) {
-                m_game.pushCommand(m_nowTime, Direction::Right);
+                pushGameCommand(Direction::Right);
                 m_rotatedPostEffect = false;
             } else if (event.key.code == sf::Keyboard::LShift ||
                        event.key.code == sf::Keyboard::RShift ||
@@ -2854,237 +2752,260 @@ void BlockSnake::processEvents() {
 }
 
 
+void BlockSnake::pushGameCommand(Direction direction) {
+    m_game.pushCommand(m_nowTime, direction);
+    m_replayRecorder.recordCommand(m_nowTime, direction);
+}
+
+
+void BlockSnake::saveReplay() const {
+    FileOutputStream foutp;
+
+    if (!foutp.open((std::string)pwd + REPLAY_PATH) ||
+        !m_replayRecorder.getReplay().saveToStream(foutp)) {
+        m_logger << "Failed to save " << REPLAY_PATH << std::endl;
+    }
+}
+
+
 void BlockSnake::processGameEvents() {
 
     auto dic = [this](ColorDst dst) {return getDestinationIntColor(dst); };
 
-    Game::Event gameEvent;
+    std::array<Game::Event, 32> gameEvents;
+    std::size_t gameEventCount;
     bool anyGameEvent = false;
-    while (m_game.pollEvent(gameEvent)) {
-        anyGameEvent = true;
-
-        SoundThrower::Parameters soundParam;
-        soundParam.volume = m_settings[(std::size_t)SettingEnum::SoundVolumePer10000] / 100.f;
-        soundParam.relativeToListener = true;
 
-        float rand0_1 = float(std::rand()) / RAND_MAX;
-        rand0_1 -= 0.5f;
-        soundParam.pitch = std::exp(rand0_1 / 15.f);
+    // drained in batches, a frame can bring many of them
+    while ((gameEventCount = m_game.pollEvents(gameEvents.data(), gameEvents.size())) != 0) {
+        anyGameEvent = true;
 
-        bool rotatedPostEffectOccured = false;
+        for (std::size_t eventIndex = 0; eventIndex < gameEventCount; ++eventIndex) {
+            const Game::Event& gameEvent = gameEvents[eventIndex];
 
-        if (gameEvent.isMain) {
-            switch (gameEvent.mainGameEvent) {
-            case MainGameEvent::BonusExceed:
-                soundParam.relativeToListener = false;
-                soundParam.position = sf::Vector3f((float)gameEvent.bonusLostEvent.x,
-                                                   (float)gameEvent.bonusLostEvent.y, 0);
-                m_soundPlayer.playSound(SoundType::BonusDisappear, soundParam);
-                break;
-            case MainGameEvent::EffectEnded:
-                m_soundPlayer.playSound(SoundType::EffectEnded, soundParam);
+            SoundThrower::Parameters soundParam;
+            soundParam.volume = m_settings[(std::size_t)SettingEnum::SoundVolumePer10000] / 100.f;
+            soundParam.relativeToListener = true;
 
-                m_gameDrawable.particles
-                    .awake(9, 40, sf::Vector2f(),
-                           dic(ColorDst::EffectEndedParticleFirst),
-                           dic(ColorDst::EffectEndedParticleSecond), 30, 80,
-                           sf::microseconds(200000), sf::microseconds(400000), 0.2f, -300, 300, 400);
-                m_particleNeedUpdatePosition = true;
+            float rand0_1 = float(std::rand()) / RAND_MAX;
+            rand0_1 -= 0.5f;
+            soundParam.pitch = std::exp(rand0_1 / 15.f);
 
-                break;
-            case MainGameEvent::Moved:
-                if (m_rotatedPostEffect)
-                    m_soundPlayer.playSound(SoundType::ForcedRotating, soundParam);
-
-                sf::Listener::setPosition((float)m_game.getImpl().getSnakeWorld().getCurrentSnakePosition().x,
-                                          (float)m_game.getImpl().getSnakeWorld().getCurrentSnakePosition().y, 0);
+            bool rotatedPostEffectOccured = false;
 
-                m_rotatedPostEffect = false;
-                m_currStepCount++;
-                m_lastMoveEventTimePoint = gameEvent.time;
+            if (gameEvent.isMain) {
+                switch (gameEvent.mainGameEvent) {
+                case MainGameEvent::BonusExceed:
+                    soundParam.relativeToListener = false;
+                    soundParam.position = sf::Vector3f((float)gameEvent.bonusLostEvent.x,
+                                                       (float)gameEvent.bonusLostEvent.y, 0);
+                    m_soundPlayer.playSound(SoundType::BonusDisappear, soundParam);
+                    break;
+                case MainGameEvent::EffectEnded:
+                    m_soundPlayer.playSound(SoundType::EffectEnded, soundParam);
 
-                // HACK
-                m_movingReserved2 = false;
+                    m_gameDrawable.particles
+                        .awake(9, 40, sf::Vector2f(),
+                               dic(ColorDst::EffectEndedParticleFirst),
+                               dic(ColorDst::EffectEndedParticleSecond), 30, 80,
+                               sf::microseconds(200000), sf::microseconds(400000), 0.2f, -300, 300, 400);
+                    m_particleNeedUpdatePosition = true;
 
-                // spikes...
-                if (!gameEvent.unpredMemory &&
-                    m_game.getImpl().getObjectMemory(m_game.getImpl().getSnakeWorld().getCurrentSnakePosition().x,
-                    m_game.getImpl().getSnakeWorld().getCurrentSnakePosition().y)) {
-                    m_soundPlayer.playSound(SoundType::ActivateSpikes, soundParam);
+                    break;
+                case MainGameEvent::Moved:
+                    if (m_rotatedPostEffect)
+                        m_soundPlayer.playSound(SoundType::ForcedRotating, soundParam);
+
+                    sf::Listener::setPosition((float)m_game.getImpl().getSnakeWorld().getCurrentSnakePosition().x,
+                                              (float)m_game.getImpl().getSnakeWorld().getCurrentSnakePosition().y, 0);
+
+                    m_rotatedPostEffect = false;
+                    m_currStepCount++;
+                    m_lastMoveEventTimePoint = gameEvent.time;
+
+                    // HACK
+                    m_movingReserved2 = false;
+
+                    // spikes...
+                    if (!gameEvent.unpredMemory &&
+                        m_game.getImpl().getObjectMemory(m_game.getImpl().getSnakeWorld().getCurrentSnakePosition().x,
+                        m_game.getImpl().getSnakeWorld().getCurrentSnakePosition().y)) {
+                        m_soundPlayer.playSound(SoundType::ActivateSpikes, soundParam);
+
+                        m_gameDrawable.particles
+                            .awake(12, 10, sf::Vector2f(),
+                                   dic(ColorDst::SpikesParticleFirst),
+                                   dic(ColorDst::SpikesParticleSecond),
+                                   5, 80, sf::microseconds(100000),
+                                   sf::microseconds(150000), 0.05f, -3000, 200, 600);
+                        m_particleNeedUpdatePosition = true;
+                    }
 
+                    break;
+                case MainGameEvent::PowerupExceed:
+                    soundParam.relativeToListener = false;
+                    soundParam.position = sf::Vector3f((float)gameEvent.powerupLostEvent.x,
+                                                       (float)gameEvent.powerupLostEvent.y, 0);
+                    m_soundPlayer.playSound(SoundType::PowerupDisappear, soundParam);
+                    break;
+                case MainGameEvent::TimeLimitExceed:
+                    m_gameClock.pause();
+                    m_soundPlayer.playSound(SoundType::TimeLimitExceedSignal, soundParam);
                     m_gameDrawable.particles
-                        .awake(12, 10, sf::Vector2f(),
-                               dic(ColorDst::SpikesParticleFirst),
-                               dic(ColorDst::SpikesParticleSecond),
-                               5, 80, sf::microseconds(100000),
-                               sf::microseconds(150000), 0.05f, -3000, 200, 600);
+                        .awake(9, 20, sf::Vector2f(),
+                               dic(ColorDst::TimeLimitExceedParticleFirst),
+                               dic(ColorDst::TimeLimitExceedParticleSecond),
+                               30, 80, sf::microseconds(200000),
+                               sf::microseconds(400000), 0.1f, -300, 300, 400);
                     m_particleNeedUpdatePosition = true;
+
+                    break;
+                default:
+                    break;
                 }
+            } else {
+                switch (gameEvent.subevent) {
+                case GameSubevent::Accelerated:
+                    switch (m_game.getImpl().getSnakeAcceleration()) {
+                    case Acceleration::Default:
+                        m_soundPlayer.playSound(SoundType::AccelerateDefault, soundParam);
+
+                        m_gameDrawable.particles
+                            .awake(7, 40, sf::Vector2f(),
+                                   dic(ColorDst::AcceleratedDefaultParticleFirst),
+                                   dic(ColorDst::AcceleratedDefaultParticleSecond),
+                                   40, 90, sf::microseconds(200000),
+                                   sf::microseconds(250000), 0.1f, -1000, 300, 450);
+                        m_particleNeedUpdatePosition = true;
+
+                        break;
+                    case Acceleration::Down:
+                        m_soundPlayer.playSound(SoundType::AccelerateDown, soundParam);
+
+                        m_gameDrawable.particles
+                            .awake(9, 50, sf::Vector2f(),
+                                   dic(ColorDst::AcceleratedDownParticleFirst),
+                                   dic(ColorDst::AcceleratedDownParticleSecond),
+                                   50, 100, sf::microseconds(300000),
+                                   sf::microseconds(450000), 0.1f, -300, 100, 150);
+                        m_particleNeedUpdatePosition = true;
+
+                        break;
+                    case Acceleration::Up:
+                        m_soundPlayer.playSound(SoundType::AccelerateUp, soundParam);
+
+                        m_gameDrawable.particles
+                            .awake(5, 100, sf::Vector2f(),
+                                   dic(ColorDst::AcceleratedUpParticleFirst),
+                                   dic(ColorDst::AcceleratedUpParticleSecond),
+                                   10, 100, sf::microseconds(150000),
+                                   sf::microseconds(200000), 0.1f, -2000, 600, 850);
+                        m_particleNeedUpdatePosition = true;
+
+                        break;
+                    default:
+                        break;
+                    }
+                    break;
+                case GameSubevent::BonusAppended:
+                    soundParam.relativeToListener = false;
+                    soundParam.position =
+                        sf::Vector3f((float)m_game.getImpl().getSnakeWorld().getBonusPositions().begin()->x,
+                                     (float)m_game.getImpl().getSnakeWorld().getBonusPositions().begin()->y, 0);
+                    m_soundPlayer.playSound(SoundType::BonusAppear, soundParam);
+                    break;
+                case GameSubevent::BonusEaten:
+                    m_soundPlayer.playSound(SoundType::ItemEat, soundParam);
 
-                break;
-            case MainGameEvent::PowerupExceed:
-                soundParam.relativeToListener = false;
-                soundParam.position = sf::Vector3f((float)gameEvent.powerupLostEvent.x,
-                                                   (float)gameEvent.powerupLostEvent.y, 0);
-                m_soundPlayer.playSound(SoundType::PowerupDisappear, soundParam);
-                break;
-            case MainGameEvent::TimeLimitExceed:
-                m_gameClock.pause();
-                m_soundPlayer.playSound(SoundType::TimeLimitExceedSignal, soundParam);
-                m_gameDrawable.particles
-                    .awake(9, 20, sf::Vector2f(),
-                           dic(ColorDst::TimeLimitExceedParticleFirst),
-                           dic(ColorDst::TimeLimitExceedParticleSecond),
-                           30, 80, sf::microseconds(200000),
-                           sf::microseconds(400000), 0.1f, -300, 300, 400);
-                m_particleNeedUpdatePosition = true;
+                    m_gameDrawable.particles
+                        .awake(7, 30, sf::Vector2f(),
+                               dic(ColorDst::BonusEatenParticleFirst),
+                               dic(ColorDst::BonusEatenParticleSecond),
+                               20, 80, sf::microseconds(300000),
+                               sf::microseconds(500000), 0.2f, -1000, 600, 600);
+                    m_particleNeedUpdatePosition = true;
 
-                break;
-            default:
-                break;
-            }
-        } else {
-            switch (gameEvent.subevent) {
-            case GameSubevent::Accelerated:
-                switch (m_game.getImpl().getSnakeAcceleration()) {
-                case Acceleration::Default:
-                    m_soundPlayer.playSound(SoundType::AccelerateDefault, soundParam);
+                    m_currBonusEatenCount++;
+                    m_currScore += m_levels.getLevelPlotDataPtr(m_difficulty,
+                                                                m_levelIndex)[(int)LevelPlotDataEnum::BonusScoreCoeff];
+                    break;
+                case GameSubevent::EffectAppended:
+                    m_soundPlayer.playSound(SoundType::EffectStarted, soundParam);
+                    break;
+                case GameSubevent::FruitEaten:
+                    m_soundPlayer.playSound(SoundType::ItemEat, soundParam);
 
                     m_gameDrawable.particles
-                        .awake(7, 40, sf::Vector2f(),
-                               dic(ColorDst::AcceleratedDefaultParticleFirst),
-                               dic(ColorDst::AcceleratedDefaultParticleSecond),
-                               40, 90, sf::microseconds(200000),
-                               sf::microseconds(250000), 0.1f, -1000, 300, 450);
+                        .awake(5, 20, sf::Vector2f(),
+                               dic(ColorDst::FruitEatenParticleFirst),
+                               dic(ColorDst::FruitEatenParticleSecond),
+                               10, 50, sf::microseconds(200000),
+                               sf::microseconds(250000), 0.1f, -2000, 600, 600);
                     m_particleNeedUpdatePosition = true;
 
+                    m_currFruitEatenCount++;
+                    m_currScore += m_levels.getLevelPlotDataPtr(m_difficulty,
+                                                                m_levelIndex)[(int)LevelPlotDataEnum::FruitScoreCoeff];
+                    break;
+                case GameSubevent::Killed:
+
+                    if (m_levelComplete)
+                        m_soundPlayer.playSound(SoundType::LevelComplete, soundParam);
+                    else
+                        m_soundPlayer.playSound(SoundType::Death, soundParam);
+
+                    m_toExit = true;
+                    m_toReturn = true;
+                    break;
+                case GameSubevent::PowerupAppended:
+                    soundParam.relativeToListener = false;
+                    soundParam.position =
+                        sf::Vector3f((float)m_game.getImpl().getSnakeWorld().getPowerups().begin()->first.x,
+                                     (float)m_game.getImpl().getSnakeWorld().getPowerups().begin()->first.y, 0);
+                    m_soundPlayer.playSound(SoundType::PowerupAppear, soundParam);
                     break;
-                case Acceleration::Down:
-                    m_soundPlayer.playSound(SoundType::AccelerateDown, soundParam);
+                case GameSubevent::PowerupEaten:
+                    if (gameEvent.powerupEatenEvent.powerup >= PowerupType::EffectCount)
+                        m_soundPlayer.playSound(SoundType::InstantPowerupChoke, soundParam);
 
                     m_gameDrawable.particles
                         .awake(9, 50, sf::Vector2f(),
-                               dic(ColorDst::AcceleratedDownParticleFirst),
-                               dic(ColorDst::AcceleratedDownParticleSecond),
-                               50, 100, sf::microseconds(300000),
-                               sf::microseconds(450000), 0.1f, -300, 100, 150);
+                               dic(ColorDst::SuperbonusEatenParticleFirst),
+                               dic(ColorDst::SuperbonusEatenParticleSecond),
+                               30, 100, sf::microseconds(400000),
+                               sf::microseconds(650000), 0.2f, -800, 600, 600);
                     m_particleNeedUpdatePosition = true;
 
+                    m_currPowerupEatenCount++;
+                    m_currScore +=
+                        m_levels.getLevelPlotDataPtr(m_difficulty,
+                                                     m_levelIndex)[(int)LevelPlotDataEnum::SuperbonusScoreCoeff];
+                    break;
+                case GameSubevent::RotatedPostEffect:
+                    rotatedPostEffectOccured = true;
+                    break;
+                case GameSubevent::RotatedPreEffect:
+                    m_soundPlayer.playSound(SoundType::ForcedRotating, soundParam);
                     break;
-                case Acceleration::Up:
-                    m_soundPlayer.playSound(SoundType::AccelerateUp, soundParam);
+                case GameSubevent::Stopped:
+                    m_soundPlayer.playSound(SoundType::StopHit, soundParam);
 
                     m_gameDrawable.particles
-                        .awake(5, 100, sf::Vector2f(),
-                               dic(ColorDst::AcceleratedUpParticleFirst),
-                               dic(ColorDst::AcceleratedUpParticleSecond),
-                               10, 100, sf::microseconds(150000),
-                               sf::microseconds(200000), 0.1f, -2000, 600, 850);
+                        .awake(6, 15, sf::Vector2f(),
+                               dic(ColorDst::StoppedParticleFirst),
+                               dic(ColorDst::StoppedParticleSecond),
+                               40, 70, sf::microseconds(200000),
+                               sf::microseconds(250000), 0.1f, -1000, 300, 400);
                     m_particleNeedUpdatePosition = true;
-
                     break;
                 default:
                     break;
                 }
-                break;
-            case GameSubevent::BonusAppended:
-                soundParam.relativeToListener = false;
-                soundParam.position =
-                    sf::Vector3f((float)m_game.getImpl().getSnakeWorld().getBonusPositions().begin()->x,
-                                 (float)m_game.getImpl().getSnakeWorld().getBonusPositions().begin()->y, 0);
-                m_soundPlayer.playSound(SoundType::BonusAppear, soundParam);
-                break;
-            case GameSubevent::BonusEaten:
-                m_soundPlayer.playSound(SoundType::ItemEat, soundParam);
-
-                m_gameDrawable.particles
-                    .awake(7, 30, sf::Vector2f(),
-                           dic(ColorDst::BonusEatenParticleFirst),
-                           dic(ColorDst::BonusEatenParticleSecond),
-                           20, 80, sf::microseconds(300000),
-                           sf::microseconds(500000), 0.2f, -1000, 600, 600);
-                m_particleNeedUpdatePosition = true;
-
-                m_currBonusEatenCount++;
-                m_currScore += m_levels.getLevelPlotDataPtr(m_difficulty,
-                                                            m_levelIndex)[(int)LevelPlotDataEnum::BonusScoreCoeff];
-                break;
-            case GameSubevent::EffectAppended:
-                m_soundPlayer.playSound(SoundType::EffectStarted, soundParam);
-                break;
-            case GameSubevent::FruitEaten:
-                m_soundPlayer.playSound(SoundType::ItemEat, soundParam);
-
-                m_gameDrawable.particles
-                    .awake(5, 20, sf::Vector2f(),
-                           dic(ColorDst::FruitEatenParticleFirst),
-                           dic(ColorDst::FruitEatenParticleSecond),
-                           10, 50, sf::microseconds(200000),
-                           sf::microseconds(250000), 0.1f, -2000, 600, 600);
-                m_particleNeedUpdatePosition = true;
-
-                m_currFruitEatenCount++;
-                m_currScore += m_levels.getLevelPlotDataPtr(m_difficulty,
-                                                            m_levelIndex)[(int)LevelPlotDataEnum::FruitScoreCoeff];
-                break;
-            case GameSubevent::Killed:
-
-                if (m_levelComplete)
-                    m_soundPlayer.playSound(SoundType::LevelComplete, soundParam);
-                else
-                    m_soundPlayer.playSound(SoundType::Death, soundParam);
-
-                m_toExit = true;
-                m_toReturn = true;
-                break;
-            case GameSubevent::PowerupAppended:
-                soundParam.relativeToListener = false;
-                soundParam.position =
-                    sf::Vector3f((float)m_game.getImpl().getSnakeWorld().getPowerups().begin()->first.x,
-                                 (float)m_game.getImpl().getSnakeWorld().getPowerups().begin()->first.y, 0);
-                m_soundPlayer.playSound(SoundType::PowerupAppear, soundParam);
-                break;
-            case GameSubevent::PowerupEaten:
-                if (gameEvent.powerupEatenEvent.powerup >= PowerupType::EffectCount)
-                    m_soundPlayer.playSound(SoundType::InstantPowerupChoke, soundParam);
-
-                m_gameDrawable.particles
-                    .awake(9, 50, sf::Vector2f(),
-                           dic(ColorDst::SuperbonusEatenParticleFirst),
-                           dic(ColorDst::SuperbonusEatenParticleSecond),
-                           30, 100, sf::microseconds(400000),
-                           sf::microseconds(650000), 0.2f, -800, 600, 600);
-                m_particleNeedUpdatePosition = true;
-
-                m_currPowerupEatenCount++;
-                m_currScore +=
-                    m_levels.getLevelPlotDataPtr(m_difficulty,
-                                                 m_levelIndex)[(int)LevelPlotDataEnum::SuperbonusScoreCoeff];
-                break;
-            case GameSubevent::RotatedPostEffect:
-                rotatedPostEffectOccured = true;
-                break;
-            case GameSubevent::RotatedPreEffect:
-                m_soundPlayer.playSound(SoundType::ForcedRotating, soundParam);
-                break;
-            case GameSubevent::Stopped:
-                m_soundPlayer.playSound(SoundType::StopHit, soundParam);
-
-                m_gameDrawable.particles
-                    .awake(6, 15, sf::Vector2f(),
-                           dic(ColorDst::StoppedParticleFirst),
-                           dic(ColorDst::StoppedParticleSecond),
-                           40, 70, sf::microseconds(200000),
-                           sf::microseconds(250000), 0.1f, -1000, 300, 400);
-                m_particleNeedUpdatePosition = true;
-                break;
-            default:
-                break;
             }
-        }
 
-        if (rotatedPostEffectOccured)
-            m_rotatedPostEffect = true;
+            if (rotatedPostEffectOccured)
+                m_rotatedPostEffect = true;
+        }
     }
 
     if (anyGameEvent) {
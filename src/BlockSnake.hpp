@@ -26,11 +26,14 @@
 #ifndef BLOCK_SNAKE_HPP
 #define BLOCK_SNAKE_HPP
 #include "Game.hpp"
+#include "Replay.hpp"
 #include "Levels.hpp"
+#include "LevelPreparation.hpp"
 #include "LevelStatistics.hpp"
 #include "GameDrawable.hpp"
 #include <SFML/Config.hpp>
 #include <bw_ext/PausableClock.hpp>
+#include <bw_ext/stream/MappedFileInputStream.hpp>
 #include <bw_ext/random/RandomizerImpl.hpp>
 #include "SoundPlayer.hpp"
 #include "engine/ObjectBehavior.hpp"
@@ -40,6 +43,7 @@
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/System/MemoryInputStream.hpp>
 #include <fstream>
 #include <memory>
 #include <filesystem>
@@ -110,7 +114,7 @@ private:
     [[nodiscard]] bool playGame();
 
     void createChallVisual();
-    void prepareGame();
+    [[nodiscard]] bool prepareGame();
     void playGameMusic();
 
     // change central view and challenge visual after move
@@ -144,8 +148,10 @@ private:
     void drawChallVis(float shaderSecs);
 
     void processEvents();
+    void pushGameCommand(Direction direction);
     void processGameEvents();
     void endGame();
+    void saveReplay() const;
 
     void pauseGame();
 
@@ -154,10 +160,12 @@ private:
     GameDrawable m_gameDrawable; // game graphics    
     std::array<sf::Shader, VisualEffectCount> m_shaders;
     // random
-    RandomizerImpl m_randomizer;
+    RandomizerImpl m_randomizer;  // the game seeds
+    std::array<RandomizerImpl, RandomTypeCount> m_gameRandomizers; // one stream per RandomizerType
     SoundPlayer m_soundPlayer;
     // main game states
     Game m_game;                 // game manager
+    ReplayRecorder m_replayRecorder; // the current game, saved on its end
     std::array<sf::Font, FontCount> m_fonts;
     sf::Cursor m_cursor; // destroy the window before destroying the cursor
     sf::RenderWindow m_window; // Window
@@ -167,6 +175,7 @@ private:
     std::array<std::uint32_t, ColorDstCount> m_colors;   // Colors
     sf::Music m_music;
     sf::Music m_ambient;
+    MappedFileInputStream m_dataStream;      // data.bin, the levels read it on demand
     Levels m_levels;
     LevelStatistics m_levelStatistics;
     // current loaded map layers
@@ -185,7 +194,7 @@ private:
 
     sf::Image m_iconImg;
     std::vector<ObjectBehavior> m_objectBehaviors;
-    std::vector<std::uint32_t> m_initialObjectMemory;
+    ElementStorage<std::uint32_t> m_initialObjectMemory;   // may borrow a cached level image
     // localization
     std::vector<sf::String> m_words;
     std::vector<std::filesystem::path>
@@ -196,10 +205,9 @@ private:
         m_fontTitles, 
         m_languageTitles, 
         m_wallpaperTitles;
-    std::vector<std::uintmax_t> m_currentSnakePosProbs;
-    std::vector<std::uint32_t> m_currentObjPairIndices;
-    std::vector<std::uint32_t> m_currentObjParams;
-    std::vector<std::uint32_t> m_currentThemes;
+    FenwickSampler<1> m_currentSnakePosProbs;
+    CellGrid<GameImpl::CellRecord> m_currentCells;
+    LevelPreparation m_levelPreparation;   // builds the ones above on its worker pool
     PausableClock m_gameClock;   // game clock
     std::shared_ptr<sf::Texture> m_menuWallpaper; // 'zero'
     std::shared_ptr<sf::Texture> m_secondCachedWallpaper;
@@ -58,6 +58,8 @@ const ResourcePath FONT_LIST_PATH = BULLETWORM_PATH_PREFIX "Resources/Lists/font
 
 const ResourcePath DATA_PATH = BULLETWORM_PATH_PREFIX "Resources/data.bin";
 const ResourcePath STATUS_PATH = BULLETWORM_PATH_PREFIX "Resources/status.bin";
+const ResourcePath REPLAY_PATH = BULLETWORM_PATH_PREFIX "Resources/replay.bin";
+const ResourcePath LEVEL_CACHE_PATH = BULLETWORM_PATH_PREFIX "Resources/Cache/";
 
 const ResourcePath LOG_PATH = "logs.log";
 
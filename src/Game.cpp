@@ -25,6 +25,7 @@
 
 #include "Game.hpp"
 #include "engine/const/AttribEnums.hpp"
+#include <limits>
 
 namespace Bulletworm {
 
@@ -70,7 +71,7 @@ void Game::pushCommand(std::int64_t now, Direction direction) {
         RotationEvent revt{};
         revt.timePoint = now;
         revt.direction = direction;
-        m_rotationEvents.push_back(revt);
+        m_rotationEvents.push(revt);
     }
 }
 
@@ -79,7 +80,7 @@ void Game::pushCommand(std::int64_t now, Direction direction) {
 bool Game::pollEvent(Event& event) noexcept {
     if (!m_eventQueue.empty()) {
         event = m_eventQueue.front();
-        m_eventQueue.pop_front();
+        m_eventQueue.pop();
         return true;
     }
     return false;
@@ -88,10 +89,41 @@ bool Game::pollEvent(Event& event) noexcept {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 void Game::update(std::int64_t now) {
+    constexpr std::uint32_t AllMainEvents = (1u << MainEventCount) - 1;
+    constexpr std::uint32_t AllSubevents = (1u << SubeventCount) - 1;
+
+    advance(now, NoMoveLimit, AllMainEvents, AllSubevents);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void Game::fastForward(std::int64_t now, std::uint32_t mainEventMask, std::uint32_t subeventMask) {
+    advance(now, NoMoveLimit, mainEventMask, subeventMask);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+std::uint64_t Game::fastForwardMoves(std::uint64_t moveCount,
+                                     std::uint32_t mainEventMask, std::uint32_t subeventMask) {
+    if (moveCount == 0)
+        return 0;
+
+    return advance(std::numeric_limits<std::int64_t>::max(), moveCount, mainEventMask, subeventMask);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+std::uint64_t Game::advance(std::int64_t now, std::uint64_t moveLimit,
+                            std::uint32_t mainEventMask, std::uint32_t subeventMask) {
+    std::uint64_t moveCount = 0;
     bool again = true; // We have to run through all following events
 
     // We additionally test Snake's life
     while (again && m_impl.isSnakeAlive()) {
+        // nothing would move Snake anymore
+        if (moveLimit != NoMoveLimit && !m_impl.isSnakeMoving() && m_rotationEvents.empty())
+            break;
+
         bool rbpFirst = false; // Whether a rotate command is being pushing now
 
         // Outer event time relative to game starting event
@@ -128,30 +160,33 @@ void Game::update(std::int64_t now) {
                     m_eventProcessor.addFutureEvent((std::size_t)MainGameEvent::Moved,
                                                     m_impl.getFactualSnakePeriod());
 
-                m_rotationEvents.pop_front();
-            } else {
-                processOuterEvent(eventTime);
+                m_rotationEvents.pop();
+            } else if (processOuterEvent(eventTime, mainEventMask, subeventMask)) {
+                ++moveCount;
             }
 
             // update the event time
             m_lastUpdateTimePoint = eventTime;
-            again = true;
+            again = (moveCount != moveLimit);
         } else {
             m_eventProcessor.goTo(now - m_lastUpdateTimePoint); // important
             m_lastUpdateTimePoint = now;
             again = false;
         }
     }
+
+    return moveCount;
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-void Game::processOuterEvent(std::int64_t eventTimePoint) {
+bool Game::processOuterEvent(std::int64_t eventTimePoint,
+                             std::uint32_t mainEventMask, std::uint32_t subeventMask) {
     constexpr std::uintmax_t MAX_ONE = 1;
 
     // Collect some previous data
     const SnakeWorld& snakeWorld = m_impl.getSnakeWorld();
-    const SnakeWorld::PowerupMap& powerups = snakeWorld.getPowerups();
+    SnakeWorld::PowerupPositions powerups = snakeWorld.getPowerups();
 
     PowerupType previousPowerup =
         (powerups.empty() ? PowerupType::NoPowerup : powerups.begin()->second);
@@ -219,6 +254,15 @@ void Game::processOuterEvent(std::int64_t eventTimePoint) {
         m_impl.killSnake();
     }
 
+    bool moved = (events & (MAX_ONE << (int)MainGameEvent::Moved)) != 0;
+
+    // the unpredictable memory stays in subevs
+    std::uintmax_t shownEvents = events & mainEventMask;
+    std::uintmax_t shownSubevs = subevs & subeventMask;
+
+    if (!shownEvents && !shownSubevs)
+        return moved;
+
     // We prefer to push events after moving
 
     Event commonMainEvent{};
@@ -232,116 +276,118 @@ void Game::processOuterEvent(std::int64_t eventTimePoint) {
     commonMainEvent.time = eventTimePoint;
     commonSubevent.time = eventTimePoint;
 
-    if (events & (MAX_ONE << (int)MainGameEvent::Moved)) {
+    if (shownEvents & (MAX_ONE << (int)MainGameEvent::Moved)) {
         Event movedEvent = commonMainEvent;
         movedEvent.mainGameEvent = MainGameEvent::Moved;
-        m_eventQueue.push_back(movedEvent);
+        m_eventQueue.push(movedEvent);
     }
 
-    if (subevs & (MAX_ONE << (int)GameSubevent::FruitEaten)) {
+    if (shownSubevs & (MAX_ONE << (int)GameSubevent::FruitEaten)) {
         Event fruitEatenEvent = commonSubevent;
         fruitEatenEvent.subevent = GameSubevent::FruitEaten;
-        m_eventQueue.push_back(fruitEatenEvent);
+        m_eventQueue.push(fruitEatenEvent);
     }
 
-    if (subevs & (MAX_ONE << (int)GameSubevent::BonusEaten)) {
+    if (shownSubevs & (MAX_ONE << (int)GameSubevent::BonusEaten)) {
         Event bonusEatenEvent = commonSubevent;
         bonusEatenEvent.subevent = GameSubevent::BonusEaten;
-        m_eventQueue.push_back(bonusEatenEvent);
+        m_eventQueue.push(bonusEatenEvent);
     }
 
-    if (subevs & (MAX_ONE << (int)GameSubevent::PowerupEaten)) {
+    if (shownSubevs & (MAX_ONE << (int)GameSubevent::PowerupEaten)) {
         Event powerupEatenEvent = commonSubevent;
         powerupEatenEvent.subevent = GameSubevent::PowerupEaten;
         powerupEatenEvent.powerupEatenEvent.powerup = previousPowerup;
-        m_eventQueue.push_back(powerupEatenEvent);
+        m_eventQueue.push(powerupEatenEvent);
     }
 
-    if (subevs & (MAX_ONE << (int)GameSubevent::RotatedPreEffect)) {
+    if (shownSubevs & (MAX_ONE << (int)GameSubevent::RotatedPreEffect)) {
         Event rotatedEvent = commonSubevent;
         rotatedEvent.subevent = GameSubevent::RotatedPreEffect;
-        m_eventQueue.push_back(rotatedEvent);
+        m_eventQueue.push(rotatedEvent);
     }
 
-    if (subevs & (MAX_ONE << (int)GameSubevent::RotatedPostEffect)) {
+    if (shownSubevs & (MAX_ONE << (int)GameSubevent::RotatedPostEffect)) {
         Event rotatedEvent = commonSubevent;
         rotatedEvent.subevent = GameSubevent::RotatedPostEffect;
-        m_eventQueue.push_back(rotatedEvent);
+        m_eventQueue.push(rotatedEvent);
     }
 
-    if (subevs & (MAX_ONE << (int)GameSubevent::Accelerated)) {
+    if (shownSubevs & (MAX_ONE << (int)GameSubevent::Accelerated)) {
         Event acceleratedEvent = commonSubevent;
         acceleratedEvent.subevent = GameSubevent::Accelerated;
-        m_eventQueue.push_back(acceleratedEvent);
+        m_eventQueue.push(acceleratedEvent);
     }
 
-    if (subevs & (MAX_ONE << (int)GameSubevent::Stopped)) {
+    if (shownSubevs & (MAX_ONE << (int)GameSubevent::Stopped)) {
         Event stoppedEvent = commonSubevent;
         stoppedEvent.subevent = GameSubevent::Stopped;
-        m_eventQueue.push_back(stoppedEvent);
+        m_eventQueue.push(stoppedEvent);
     }
 
-    if (subevs & (MAX_ONE << (int)GameSubevent::Killed)) {
+    if (shownSubevs & (MAX_ONE << (int)GameSubevent::Killed)) {
         Event killedEvent = commonSubevent;
         killedEvent.subevent = GameSubevent::Killed;
-        m_eventQueue.push_back(killedEvent);
+        m_eventQueue.push(killedEvent);
     }
 
-    if (subevs & (MAX_ONE << (int)GameSubevent::BonusAppended)) {
+    if (shownSubevs & (MAX_ONE << (int)GameSubevent::BonusAppended)) {
         Event bonusAppendedEvent = commonSubevent;
         bonusAppendedEvent.subevent = GameSubevent::BonusAppended;
-        m_eventQueue.push_back(bonusAppendedEvent);
+        m_eventQueue.push(bonusAppendedEvent);
     }
 
-    if (subevs & (MAX_ONE << (int)GameSubevent::PowerupAppended)) {
+    if (shownSubevs & (MAX_ONE << (int)GameSubevent::PowerupAppended)) {
         Event powerupAppendedEvent = commonSubevent;
         powerupAppendedEvent.subevent = GameSubevent::PowerupAppended;
-        m_eventQueue.push_back(powerupAppendedEvent);
+        m_eventQueue.push(powerupAppendedEvent);
     }
 
-    if (subevs & (MAX_ONE << (int)GameSubevent::EffectAppended)) {
+    if (shownSubevs & (MAX_ONE << (int)GameSubevent::EffectAppended)) {
         Event effectAppendedEvent = commonSubevent;
         effectAppendedEvent.subevent = GameSubevent::EffectAppended;
-        m_eventQueue.push_back(effectAppendedEvent);
+        m_eventQueue.push(effectAppendedEvent);
     }
 
-    if (events & (MAX_ONE << (int)MainGameEvent::BonusExceed)) {
+    if (shownEvents & (MAX_ONE << (int)MainGameEvent::BonusExceed)) {
         Event bonusLostEvent = commonMainEvent;
         bonusLostEvent.mainGameEvent = MainGameEvent::BonusExceed;
         bonusLostEvent.bonusLostEvent.x = previousBonusPosition.x;
         bonusLostEvent.bonusLostEvent.y = previousBonusPosition.y;
-        m_eventQueue.push_back(bonusLostEvent);
+        m_eventQueue.push(bonusLostEvent);
     }
 
-    if (events & (MAX_ONE << (int)MainGameEvent::PowerupExceed)) {
+    if (shownEvents & (MAX_ONE << (int)MainGameEvent::PowerupExceed)) {
         Event powerupLostEvent = commonMainEvent;
         powerupLostEvent.mainGameEvent = MainGameEvent::PowerupExceed;
         powerupLostEvent.powerupLostEvent.powerup = previousPowerup;
         powerupLostEvent.powerupLostEvent.x = previousPowerupPosition.x;
         powerupLostEvent.powerupLostEvent.y = previousPowerupPosition.y;
-        m_eventQueue.push_back(powerupLostEvent);
+        m_eventQueue.push(powerupLostEvent);
     }
 
-    if (events & (MAX_ONE << (int)MainGameEvent::EffectEnded)) {
+    if (shownEvents & (MAX_ONE << (int)MainGameEvent::EffectEnded)) {
         Event effectEndedEvent = commonMainEvent;
         effectEndedEvent.mainGameEvent = MainGameEvent::EffectEnded;
         effectEndedEvent.effectEndedEvent.effect = previousEffect;
-        m_eventQueue.push_back(effectEndedEvent);
+        m_eventQueue.push(effectEndedEvent);
     }
 
-    if (events & (MAX_ONE << (int)MainGameEvent::TimeLimitExceed)) {
+    if (shownEvents & (MAX_ONE << (int)MainGameEvent::TimeLimitExceed)) {
         Event timeLimitExceededEvent = commonMainEvent;
         timeLimitExceededEvent.mainGameEvent = MainGameEvent::TimeLimitExceed;
-        m_eventQueue.push_back(timeLimitExceededEvent);
+        m_eventQueue.push(timeLimitExceededEvent);
     }
+
+    return moved;
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 void Game::innerRestart() noexcept {
     m_lastUpdateTimePoint = 0;
-    std::list<Event>().swap(m_eventQueue);
-    std::list<RotationEvent>().swap(m_rotationEvents);
+    m_eventQueue.clear();
+    m_rotationEvents.clear();
     m_eventProcessor.clear();
     m_eventProcessor.addFutureEvent((std::size_t)(MainGameEvent::TimeLimitExceed),
                                     m_impl.getLevelPointers()
@@ -26,9 +26,9 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 #include <bw_ext/EventProcessor.hpp>
+#include <bw_ext/RingQueue.hpp>
 #include "engine/const/EventEnums.hpp"
 #include "engine/GameImpl.hpp"
-#include <list>
 
 namespace Bulletworm {
 
@@ -103,10 +103,27 @@ public:
 /// Update the game states. Fills the event queue.
     void update(std::int64_t now);
 
+    /// Fast-forward: update the game states as update() does,
+    /// but put into the queue only the events of the masks
+    /// (bits of MainGameEvent and GameSubevent), the others are never built.
+    void fastForward(std::int64_t now, std::uint32_t mainEventMask = 0, std::uint32_t subeventMask = 0);
+
+    /// Fast-forward by moves instead of time: stops after the moveCount-th move,
+    /// on death or if Snake stands and no command is pushed.
+    /// Returns the number of the made moves, getTime() is the time of the last event.
+    std::uint64_t fastForwardMoves(std::uint64_t moveCount,
+                                   std::uint32_t mainEventMask = 0, std::uint32_t subeventMask = 0);
+
     /// Extract one event from the queue.
     /// If the queue is empty, the method returns false.
     [[nodiscard]] bool pollEvent(Event& event) noexcept;
 
+    /// Extract at most count events from the queue in one call.
+    /// Returns the number of the extracted events (0 if the queue is empty).
+    [[nodiscard]] std::size_t pollEvents(Event* events, std::size_t count) noexcept {
+        return m_eventQueue.pop(events, count);
+    }
+
     void pushCommand(std::int64_t now, Direction direction);
 
     const GameImpl& getImpl() const noexcept {
@@ -117,12 +134,25 @@ public:
         return m_eventProcessor;
     }
 
+    /// The time point the game states are updated to
+    std::int64_t getTime() const noexcept {
+        return m_lastUpdateTimePoint;
+    }
+
 private:
 
     void innerRestart() noexcept;
 
-    /// Process the outer event on update
-    void processOuterEvent(std::int64_t eventTimePoint);
+    static constexpr std::uint64_t NoMoveLimit = ~std::uint64_t();
+
+    /// update() and the fast-forward, returns the number of the moves
+    std::uint64_t advance(std::int64_t now, std::uint64_t moveLimit,
+                          std::uint32_t mainEventMask, std::uint32_t subeventMask);
+
+    /// Process the outer event on update, enqueues only the events of the masks.
+    /// Returns true if Snake has moved.
+    bool processOuterEvent(std::int64_t eventTimePoint,
+                           std::uint32_t mainEventMask, std::uint32_t subeventMask);
 
     /// Represents rotate command
     struct RotationEvent {
@@ -132,8 +162,8 @@ private:
 
     GameImpl m_impl;                             // Game implementation
     GameEventProcessor m_eventProcessor;
-    std::list<Event> m_eventQueue;               // Event queue that simplifies the work with events
-    std::list<RotationEvent> m_rotationEvents;
+    RingQueue<Event> m_eventQueue;               // Event queue that simplifies the work with events
+    RingQueue<RotationEvent> m_rotationEvents;
     std::int64_t m_lastUpdateTimePoint = 0;      // Time that is ordered to game implementation status
 };
 
@@ -42,10 +42,7 @@ std::optional<std::string> LanguageLoader::loadFromStream(BackIterator wordInser
             return "Language file reading failure";
 
         // endianness
-        std::for_each(content.data(), content.data() + contentByteSize/sizeof(std::uint32_t),
-                      [](std::uint32_t& v) {
-                          v = n2hl(v);
-                      });
+        n2hl(content.data(), (std::size_t)contentByteSize / sizeof(std::uint32_t));
     }
 
     std::size_t wordSize = 0;
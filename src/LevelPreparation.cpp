@@ -0,0 +1,472 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+#include "LevelPreparation.hpp"
+#include "Levels.hpp"
+#include "LevelElements.hpp"
+#include "engine/ObjectBehavior.hpp"
+#include "engine/const/AttribEnums.hpp"
+#include <bw_ext/RunLengthMap.hpp>
+#include <bw_ext/stream/FileOutputStream.hpp>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace {
+
+using namespace Bulletworm;
+
+using Stage = LevelPreparation::Stage;
+
+static_assert((int)Stage::FruitProbabilities + (int)EatableItem::Bonus == (int)Stage::BonusProbabilities &&
+              (int)Stage::FruitProbabilities + (int)EatableItem::Powerup == (int)Stage::PowerupProbabilities &&
+              ItemCount == 3, "one probability stage per item");
+
+// The building stages, the longest ones go first
+constexpr std::array<Stage, 6> Tasks{
+    Stage::CellRecords,
+    Stage::SnakePositions,
+    Stage::FruitProbabilities,
+    Stage::BonusProbabilities,
+    Stage::PowerupProbabilities,
+    Stage::ObjectMemory
+};
+
+std::int64_t getElapsedMcs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - since).count();
+}
+
+// Cached images: the header then the sections in the host order and layout,
+// every section is aligned for any node of the trees
+
+constexpr std::uint32_t ImageMagic = 0x4c505742; // "BWPL"
+constexpr std::size_t SectionAlignment = 64;
+
+enum class Section {
+    ObjectMemory,
+    SnakeNodes,
+    SnakeLeaves,
+    FruitProbabilities,   // one per EatableItem
+    BonusProbabilities,
+    PowerupProbabilities,
+    Cells,
+
+    Count
+};
+
+constexpr int SectionCount = (int)Section::Count;
+
+struct ImageSection {
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+};
+
+struct ImageHeader {
+    std::uint32_t magic = ImageMagic;
+    std::uint32_t formatVersion = LevelPreparation::CacheFormatVersion;
+    std::uint64_t key = 0;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::uint32_t layout = 0;
+    std::uint32_t snakePositionsWide = 0;
+    std::array<ImageSection, SectionCount> sections{};
+};
+
+using SnakeSampler = FenwickSampler<1>;
+
+std::size_t alignSection(std::size_t offset) {
+    return (offset + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+}
+
+// The only valid sections of the size and the layout
+std::array<std::uint64_t, SectionCount> getSectionSizes(const sf::Vector2u& mapSize, GridLayout layout,
+                                                        bool snakePositionsWide) {
+    std::size_t area = (std::size_t)mapSize.x * mapSize.y;
+    std::size_t nodeCount = MultiFenwickTree<std::uint32_t, 1>::getNodeCount(area);
+    std::size_t nodeSize = snakePositionsWide ? MultiFenwickTree<std::uint64_t, 1>::getNodeSize() :
+        MultiFenwickTree<std::uint32_t, 1>::getNodeSize();
+
+    std::array<std::uint64_t, SectionCount> sizes{};
+    sizes[(int)Section::ObjectMemory] = area * sizeof(std::uint32_t);
+    sizes[(int)Section::SnakeNodes] = (nodeCount + 1) * nodeSize;
+    sizes[(int)Section::SnakeLeaves] = nodeCount * sizeof(SnakeSampler::Leaf);
+    for (int i = 0; i < ItemCount; ++i)
+        sizes[(int)Section::FruitProbabilities + i] = area * sizeof(std::uint32_t);
+    sizes[(int)Section::Cells] = CellGrid<GameImpl::CellRecord>::getElementCount(mapSize, layout) *
+        sizeof(GameImpl::CellRecord);
+
+    return sizes;
+}
+
+// FNV-1a over the words, the chunks of the count maps go to two lanes (counts and values)
+// to halve the multiplication chain
+class KeyHash {
+public:
+
+    void add(std::uint64_t word) noexcept {
+        m_hash = mix(m_hash, word);
+    }
+
+    // the chunks covering the area
+    void addChunks(const std::uint32_t* chunks, std::size_t area) noexcept {
+        std::uint64_t counts = m_hash;
+        std::uint64_t values = ~m_hash;
+
+        for (std::size_t end = 0; end < area; chunks += 2) {
+            end += chunks[0];
+            counts = mix(counts, chunks[0]);
+            values = mix(values, chunks[1]);
+        }
+
+        add(counts);
+        add(values);
+    }
+
+    std::uint64_t get() const noexcept {
+        return m_hash;
+    }
+
+private:
+
+    static std::uint64_t mix(std::uint64_t hash, std::uint64_t word) noexcept {
+        return (hash ^ word) * 1099511628211ull;
+    }
+
+    std::uint64_t m_hash = 14695981039346656037ull;
+};
+
+// Everything the prepared structures are derived from
+std::uint64_t computeKey(const Levels& levels, unsigned int difficulty, unsigned int levelIndex,
+                         const GameImpl::LevelPointers& levelPtrs, bool withThemes, GridLayout layout) {
+    KeyHash hash;
+
+    // the format and the host
+    const std::uint32_t byteOrder = 0x01020304;
+    hash.add(LevelPreparation::CacheFormatVersion);
+    hash.add(*reinterpret_cast<const std::uint8_t*>(&byteOrder));
+    hash.add(sizeof(GameImpl::CellRecord));
+    hash.add(withThemes);
+    hash.add((std::uint64_t)layout);
+
+    const sf::Vector2u& mapSize = levels.getMapSize(difficulty, levelIndex);
+    std::size_t area = (std::size_t)mapSize.x * mapSize.y;
+    hash.add(mapSize.x);
+    hash.add(mapSize.y);
+
+    // loadLevel has checked the areas
+    for (int i = 0; i < LevelCountMapCount; ++i)
+        hash.addChunks(levels.getLevelCountMap(LevelCountMap(i), difficulty, levelIndex), area);
+    for (int i = 0; i < ItemCount; ++i)
+        hash.addChunks(levels.getItemProbCountMap(EatableItem(i), difficulty, levelIndex), area);
+
+    // what buildCellRecords reads
+    for (int i = 0; i < ObjectPairCount; ++i) {
+        hash.add(levelPtrs.preEffectBehIndices[i]);
+        hash.add(levelPtrs.postEffectBehIndices[i]);
+        hash.add(levelPtrs.tailCapacities1[i]);
+        hash.add(levelPtrs.objectBehs[levelPtrs.preEffectBehIndices[i]].isInert());
+        hash.add(levelPtrs.objectBehs[levelPtrs.postEffectBehIndices[i]].isInert());
+    }
+
+    return hash.get();
+}
+
+// The destination borrows the sections if the image is valid
+bool readImage(const MappedFile& image, std::uint64_t key, const sf::Vector2u& mapSize,
+               GridLayout layout, const LevelPreparation::Destination& destination) {
+    if (image.getSize() < sizeof(ImageHeader))
+        return false;
+
+    const auto* bytes = static_cast<const unsigned char*>(image.getData());
+    const auto& header = *reinterpret_cast<const ImageHeader*>(bytes);
+
+    if (header.magic != ImageMagic || header.formatVersion != LevelPreparation::CacheFormatVersion ||
+        header.key != key || header.width != mapSize.x || header.height != mapSize.y ||
+        header.layout != (std::uint32_t)layout || header.snakePositionsWide > 1)
+        return false;
+
+    std::array<std::uint64_t, SectionCount> sizes = getSectionSizes(mapSize, layout,
+                                                                    header.snakePositionsWide);
+
+    for (int i = 0; i < SectionCount; ++i) {
+        const ImageSection& section = header.sections[i];
+
+        if (section.size != sizes[i] || section.offset % SectionAlignment ||
+            section.offset > image.getSize() || image.getSize() - section.offset < section.size)
+            return false;
+    }
+
+    auto getSection = [&](Section section) {
+        return bytes + header.sections[(int)section].offset;
+    };
+
+    std::size_t area = (std::size_t)mapSize.x * mapSize.y;
+
+    destination.objectMemory->borrow(
+        reinterpret_cast<const std::uint32_t*>(getSection(Section::ObjectMemory)), area);
+
+    destination.snakePositionProbs->borrow(header.snakePositionsWide, area,
+        getSection(Section::SnakeNodes),
+        reinterpret_cast<const SnakeSampler::Leaf*>(getSection(Section::SnakeLeaves)));
+
+    for (int i = 0; i < ItemCount; ++i)
+        destination.itemProbabilities[i].borrow(mapSize, reinterpret_cast<const std::uint32_t*>(
+            getSection(Section((int)Section::FruitProbabilities + i))));
+
+    destination.cells->borrow(mapSize, layout,
+        reinterpret_cast<const GameImpl::CellRecord*>(getSection(Section::Cells)));
+
+    return true;
+}
+
+// To a temporary file renamed over the old image at the end
+bool writeImage(const std::filesystem::path& path, std::uint64_t key, const sf::Vector2u& mapSize,
+                GridLayout layout, const LevelPreparation::Destination& destination) {
+    const SnakeSampler& snakePositions = *destination.snakePositionProbs;
+
+    ImageHeader header;
+    header.key = key;
+    header.width = mapSize.x;
+    header.height = mapSize.y;
+    header.layout = (std::uint32_t)layout;
+    header.snakePositionsWide = snakePositions.isWide();
+
+    std::array<const void*, SectionCount> data{};
+    data[(int)Section::ObjectMemory] = destination.objectMemory->data();
+    data[(int)Section::SnakeNodes] = snakePositions.getNodeData();
+    data[(int)Section::SnakeLeaves] = snakePositions.getLeafData();
+    for (int i = 0; i < ItemCount; ++i)
+        data[(int)Section::FruitProbabilities + i] = destination.itemProbabilities[i].data();
+    data[(int)Section::Cells] = destination.cells->data();
+
+    std::array<std::uint64_t, SectionCount> sizes = getSectionSizes(mapSize, layout,
+                                                                    header.snakePositionsWide);
+
+    std::size_t offset = sizeof(ImageHeader);
+    for (int i = 0; i < SectionCount; ++i) {
+        offset = alignSection(offset);
+        header.sections[i].offset = offset;
+        header.sections[i].size = sizes[i];
+        offset += sizes[i];
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+
+    std::filesystem::path temporaryPath = path;
+    temporaryPath += ".tmp";
+
+    bool written = false;
+
+    {
+        FileOutputStream output;
+        if (output.open(temporaryPath)) {
+            const char padding[SectionAlignment]{};
+            written = output.write(&header, sizeof(header)) == (std::int64_t)sizeof(header);
+
+            std::size_t position = sizeof(header);
+            for (int i = 0; i < SectionCount && written; ++i) {
+                std::size_t paddingSize = header.sections[i].offset - position;
+
+                written = output.write(padding, paddingSize) == (std::int64_t)paddingSize &&
+                    output.write(data[i], sizes[i]) == (std::int64_t)sizes[i];
+
+                position = header.sections[i].offset + sizes[i];
+            }
+        }
+    }
+
+    if (written)
+        std::filesystem::rename(temporaryPath, path, error);
+
+    if (!written || error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    return true;
+}
+
+}
+
+namespace Bulletworm {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+LevelPreparation::LevelPreparation(unsigned int threadCount) :
+    m_pool(threadCount ? threadCount :
+           std::min((unsigned int)Tasks.size(), std::max(1u, std::thread::hardware_concurrency()))) {}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+bool LevelPreparation::prepare(Levels& levels, unsigned int difficulty, unsigned int levelIndex,
+                               bool withThemes, GridLayout layout,
+                               const Destination& destination, GameImpl::LevelPointers& levelPtrs) {
+    m_timings = Timings();
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // the count maps are decoded on demand
+    if (!levels.loadLevel(difficulty, levelIndex))
+        return false;
+
+    m_timings.stageMcs[(int)Stage::Loading] = getElapsedMcs(startTime);
+
+    levelPtrs.attribArray = levels.getLevelAttribPtr(difficulty, levelIndex);
+    levelPtrs.effectDurations = levels.getEffectDurationPtr(difficulty, levelIndex);
+    levelPtrs.powerupProbs = &levels.getPowerupProbs(difficulty, levelIndex);
+
+    const sf::Vector2u& mapSize = levels.getMapSize(difficulty, levelIndex);
+    std::size_t area{ (std::size_t)mapSize.x * mapSize.y };
+
+    std::filesystem::path imagePath;
+    std::uint64_t key = 0;
+
+    if (!m_cacheDirectory.empty()) {
+        auto readingStartTime = std::chrono::steady_clock::now();
+
+        imagePath = m_cacheDirectory / ("level_" + std::to_string(difficulty) + '_' +
+                                        std::to_string(levelIndex) + ".bin");
+        key = computeKey(levels, difficulty, levelIndex, levelPtrs, withThemes, layout);
+
+        MappedFile image;
+        if (image.open(imagePath) && readImage(image, key, mapSize, layout, destination)) {
+            m_cacheImage = std::move(image); // the previous one is not borrowed any more
+            m_timings.cached = true;
+        }
+
+        m_timings.stageMcs[(int)Stage::CacheReading] = getElapsedMcs(readingStartTime);
+    }
+
+    if (!m_timings.cached) {
+        // the never changed maps stay run-length encoded (loadLevel has checked the areas),
+        // every task expands its own ones
+        auto getCountMap = [&](LevelCountMap what) {
+            RunLengthMap map;
+            (void)map.assign(levels.getLevelCountMap(what, difficulty, levelIndex), mapSize);
+            return map;
+        };
+
+        auto runTask = [&](std::size_t task) {
+            auto taskStartTime = std::chrono::steady_clock::now();
+            Stage stage = Tasks[task];
+
+            switch (stage) {
+            case Stage::CellRecords:
+            {
+                RunLengthMap themes;
+                if (withThemes)
+                    themes = getCountMap(LevelCountMap::Theme);
+
+                GameImpl::buildCellRecords(levelPtrs, ObjectPairCount,
+                                           getCountMap(LevelCountMap::ObjPair),
+                                           getCountMap(LevelCountMap::Param),
+                                           withThemes ? &themes : nullptr,
+                                           layout, *destination.cells);
+                break;
+            }
+            case Stage::SnakePositions:
+            {
+                std::vector<std::uint32_t> values(area);
+                getCountMap(LevelCountMap::SnakeStartPos).expand(values.data());
+
+                const std::uint32_t* leaves = values.data();
+                destination.snakePositionProbs->create(values.size(), &leaves);
+                break;
+            }
+            case Stage::FruitProbabilities:
+            case Stage::BonusProbabilities:
+            case Stage::PowerupProbabilities:
+            {
+                EatableItem item = EatableItem((int)stage - (int)Stage::FruitProbabilities);
+                Map<std::uint32_t>& probabilities = destination.itemProbabilities[(int)item];
+
+                RunLengthMap map;
+                (void)map.assign(levels.getItemProbCountMap(item, difficulty, levelIndex), mapSize);
+
+                probabilities.create(mapSize, 0u);
+                map.expand(probabilities.data());
+                break;
+            }
+            case Stage::ObjectMemory:
+                destination.objectMemory->resize(area);
+                getCountMap(LevelCountMap::Memory).expand(destination.objectMemory->data());
+                break;
+            default:
+                break;
+            }
+
+            // the tasks write their own entries
+            m_timings.stageMcs[(int)stage] = getElapsedMcs(taskStartTime);
+        };
+
+        m_pool.runTasks(Tasks.size(), runTask);
+
+        // the destination owns everything now
+        m_cacheImage.close();
+
+        if (!imagePath.empty()) {
+            auto writingStartTime = std::chrono::steady_clock::now();
+            (void)writeImage(imagePath, key, mapSize, layout, destination);
+            m_timings.stageMcs[(int)Stage::CacheWriting] = getElapsedMcs(writingStartTime);
+        }
+    }
+
+    levelPtrs.snakePositionProbs = destination.snakePositionProbs;
+    levelPtrs.cells = destination.cells;
+
+    m_timings.elapsedMcs = getElapsedMcs(startTime);
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+const char* LevelPreparation::getStageName(Stage stage) noexcept {
+    switch (stage) {
+    case Stage::Loading:
+        return "loading";
+    case Stage::CacheReading:
+        return "cache reading";
+    case Stage::CellRecords:
+        return "cell records";
+    case Stage::SnakePositions:
+        return "snake positions";
+    case Stage::FruitProbabilities:
+        return "fruit probabilities";
+    case Stage::BonusProbabilities:
+        return "bonus probabilities";
+    case Stage::PowerupProbabilities:
+        return "powerup probabilities";
+    case Stage::ObjectMemory:
+        return "object memory";
+    case Stage::CacheWriting:
+        return "cache writing";
+    default:
+        return "";
+    }
+}
+
+} // namespace Bulletworm
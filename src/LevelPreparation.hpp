@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+#ifndef LEVEL_PREPARATION_HPP
+#define LEVEL_PREPARATION_HPP
+#include "engine/GameImpl.hpp"
+#include "engine/const/EatableItem.hpp"
+#include <bw_ext/ElementStorage.hpp>
+#include <bw_ext/MappedFile.hpp>
+#include <bw_ext/WorkerPool.hpp>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+
+namespace Bulletworm {
+
+class Levels;
+
+/// Turns the count maps of a level into the structures GameImpl works on.
+/// Every map is decoded and built by its own task on the worker pool;
+/// the caller constructs GameImpl once prepare() has joined the tasks.
+///
+/// With a cache directory the prepared structures are written there as one image per level,
+/// keyed by a hash of what they are derived from (the level maps, the object pair links and
+/// CacheFormatVersion). Later a matching image is mapped read-only instead of building:
+/// the structures borrow its memory, so the start no longer grows with the map area.
+class LevelPreparation {
+public:
+
+    // Bump when the prepared structures or their building change
+    static constexpr std::uint32_t CacheFormatVersion = 1;
+
+    enum class Stage {
+        Loading,              // Levels::loadLevel, before the tasks
+        CacheReading,         // the key and the mapping of a cached image
+        CellRecords,
+        SnakePositions,
+        FruitProbabilities,   // one per EatableItem
+        BonusProbabilities,
+        PowerupProbabilities,
+        ObjectMemory,
+        CacheWriting,         // after the tasks if the image didn't match
+
+        Count
+    };
+
+    static constexpr int StageCount = (int)Stage::Count;
+
+    struct Timings {
+        std::array<std::int64_t, StageCount> stageMcs{};   // measured on the task itself
+        std::int64_t elapsedMcs = 0;                       // wall clock of the whole prepare()
+        bool cached = false;                               // mapped, no task has run
+    };
+
+    /// The prepared structures (must outlive the game using them)
+    struct Destination {
+        ElementStorage<std::uint32_t>* objectMemory = nullptr; // initial object memory
+        FenwickSampler<1>* snakePositionProbs = nullptr;
+        Map<std::uint32_t>* itemProbabilities = nullptr;      // ItemCount maps
+        CellGrid<GameImpl::CellRecord>* cells = nullptr;
+    };
+
+    /// 0 means one thread per task at most hardware concurrency
+    explicit LevelPreparation(unsigned int threadCount = 0);
+
+    /// Loads the level and fills the destination. levelPtrs must have the object behavior links
+    /// (buildCellRecords reads them), the level ones are set here.
+    /// The themes are needed only for drawing.
+    [[nodiscard]] bool prepare(Levels& levels, unsigned int difficulty, unsigned int levelIndex,
+                               bool withThemes, GridLayout layout,
+                               const Destination& destination, GameImpl::LevelPointers& levelPtrs);
+
+    /// Empty (the default) disables the cache, the directory is created on the first write
+    void setCacheDirectory(const std::filesystem::path& directory) {
+        m_cacheDirectory = directory;
+    }
+
+    /// Of the last prepare()
+    const Timings& getTimings() const noexcept {
+        return m_timings;
+    }
+
+    static const char* getStageName(Stage stage) noexcept;
+
+private:
+
+    WorkerPool m_pool;
+    Timings m_timings;
+    std::filesystem::path m_cacheDirectory;
+    MappedFile m_cacheImage;   // the last mapped one, the destination may borrow it
+};
+
+} // namespace Bulletworm
+
+#endif // !LEVEL_PREPARATION_HPP
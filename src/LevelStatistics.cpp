@@ -181,30 +181,14 @@ unsigned int LevelStatistics::getLevelGameCount(unsigned int difficulty,
 
 
 bool LevelStatistics::loadFromStream(sf::InputStream& stream, bool endiannessRequired) {
-    std::int64_t ctntsize = 0;
-    std::uint32_t* ctntdata = nullptr;
-    std::int64_t readCtnt = 0;
-
     std::array<std::uint32_t, FirstLevelStatisticsCount> first{};
     std::vector<std::uint32_t> levelCompleted;
     std::vector<std::uint32_t> levelScores;
     std::vector<std::uint32_t> levelGameCounts;
 
-    ctntdata = first.data();
-    ctntsize = (std::int64_t)sizeof(std::uint32_t) * first.size();
-
-    readCtnt = stream.read(ctntdata, ctntsize);
-    if (readCtnt != ctntsize)
+    if (!readN2hl(stream, first.data(), first.size(), endiannessRequired))
         return false;
 
-    // endianness
-    std::for_each(ctntdata, ctntdata + first.size(),
-                  [&endiannessRequired](uint32_t& v) {
-                      if (endiannessRequired) {
-                          v = n2hl(v);
-                      }
-                  });
-
     std::uint32_t diffn = first[(std::size_t)FirstLevelStatisticsEnum::DiffCount];
     std::uint32_t lvln = first[(std::size_t)FirstLevelStatisticsEnum::LevelCount];
 
@@ -217,26 +201,7 @@ bool LevelStatistics::loadFromStream(sf::InputStream& stream, bool endiannessReq
     levelGameCounts.resize((std::size_t)diffn * lvln);
 
     auto func = [&stream, &endiannessRequired](std::vector<std::uint32_t>& vec) {
-        std::int64_t lctntsize = 0;
-        std::uint32_t* lctntdata = nullptr;
-        std::int64_t lreadCtnt = 0;
-
-        lctntdata = vec.data();
-        lctntsize = (std::int64_t)sizeof(std::uint32_t) * vec.size();
-
-        lreadCtnt = stream.read(lctntdata, lctntsize);
-        if (lreadCtnt != lctntsize)
-            return false;
-
-        // endianness
-        std::for_each(lctntdata, lctntdata + vec.size(),
-                      [&endiannessRequired](uint32_t& v) {
-                          if (endiannessRequired) {
-                              v = n2hl(v);
-                          }
-                      });
-
-        return true;
+        return readN2hl(stream, vec.data(), vec.size(), endiannessRequired);
     };
 
     if (!func(levelCompleted))
@@ -298,13 +263,9 @@ bool LevelStatistics::saveToStream(OutputStream& stream, bool withEndianness) co
     ctntsize = (std::int64_t)sizeof(std::uint32_t) * m_first.size();
 
     // endianness
-    std::array<std::uint32_t, FirstLevelStatisticsCount> networkData;
-    std::transform(m_first.begin(), m_first.end(), networkData.begin(),
-                   [&withEndianness](std::uint32_t v) {
-                       if (withEndianness)
-                           return h2nl(v);
-                       return v;
-                   });
+    std::array<std::uint32_t, FirstLevelStatisticsCount> networkData = m_first;
+    if (withEndianness)
+        h2nl(networkData.data(), networkData.size());
 
     readctnt = stream.write(networkData.data(), ctntsize);
     if (readctnt != ctntsize)
@@ -312,13 +273,9 @@ bool LevelStatistics::saveToStream(OutputStream& stream, bool withEndianness) co
 
     auto func = [&stream, &withEndianness](const std::vector<std::uint32_t>& src) {
         // endianness
-        std::vector<std::uint32_t> srcnet(src.size());
-        std::transform(src.begin(), src.end(), srcnet.begin(),
-                       [&withEndianness](std::uint32_t v) {
-                           if (withEndianness)
-                               return h2nl(v);
-                           return v;
-                       });
+        std::vector<std::uint32_t> srcnet(src.begin(), src.end());
+        if (withEndianness)
+            h2nl(srcnet.data(), srcnet.size());
 
         std::int64_t lctntsize = (std::int64_t)sizeof(std::uint32_t) * src.size();
         std::int64_t lreadctnt = stream.write(srcnet.data(), lctntsize);
@@ -28,10 +28,11 @@
 #include "Constants.hpp"
 #include <array>
 #include "engine/const/AttribEnums.hpp"
-#include <SFML/System/FileInputStream.hpp>
+#include <SFML/System/InputStream.hpp>
 #include "engine/const/EatableItem.hpp"
 #include <bw_ext/Endianness.hpp>
 #include <cassert>
+#include <algorithm>
 
 namespace {
 
@@ -78,34 +79,21 @@ bool Levels::loadFromStream(unsigned int diffCount,
 	std::vector<std::uint32_t> effectDurations(diffCount * levelCount * EffectCount);
 	std::vector<std::array<std::uintmax_t, fwkGetRealSizeLvl<std::size_t, int>(PowerupCount)>> powerupProbs(diffCount * levelCount);
 	std::vector<sf::Vector2u> mapSizes(diffCount * levelCount);
-	std::vector<std::vector<std::uint32_t>> levelCountMaps(diffCount * levelCount * LevelCountMapCount);
-	std::vector<std::vector<std::uint32_t>> itemProbCountMaps(diffCount * levelCount * ItemCount);
+	std::vector<CountMapEntry> countMapIndex(diffCount * levelCount * (LevelCountMapCount + ItemCount));
 
 	std::array<std::uint32_t, PowerupCount> tempPowerupProb{};
 	std::array<std::uint32_t, 2> tempTwo{};
 
 	for (unsigned int lvl = 0; lvl < levelCount; ++lvl) {
 		for (unsigned int diff = 0; diff < diffCount; ++diff) {
-			std::int64_t readContent = 0;
-
 			// attributes
 			std::uint32_t* ctntdata = levelAttributes.data() +
 				(lvl + diff * levelCount) * LevelAttribCount;
 			std::int64_t ctntsize = (std::int64_t)sizeof(std::uint32_t) * LevelAttribCount;
 
-			auto loadFunc = [&readContent, &ctntdata, &ctntsize, &stream, &endiannessRequired]()->bool {
-				readContent = stream.read(ctntdata, ctntsize);
-				bool success = (readContent == ctntsize);
-				if (success) {
-					// endianness
-					if (endiannessRequired) {
-						std::for_each(ctntdata, ctntdata + ctntsize / sizeof(std::uint32_t),
-									  [](std::uint32_t& v) {
-										  v = n2hl(v);
-									  });
-					}
-				}
-				return success;
+			auto loadFunc = [&ctntdata, &ctntsize, &stream, &endiannessRequired]()->bool {
+				return readN2hl(stream, ctntdata, (std::size_t)ctntsize / sizeof(std::uint32_t),
+								endiannessRequired);
 			};
 
 			if (!loadFunc())
@@ -148,72 +136,28 @@ bool Levels::loadFromStream(unsigned int diffCount,
 			mapSizes[lvl + (std::size_t)diff * levelCount].x = tempTwo[0];
 			mapSizes[lvl + (std::size_t)diff * levelCount].y = tempTwo[1];
 
-			auto func = [&tempTwo, &stream, &lvl, &diff, &levelCount, &mapSizes, &endiannessRequired]
-			(int fcount, std::vector<std::vector<std::uint32_t>>& ftarget)->bool {
-				for (int levelCntId = 0; levelCntId < fcount; ++levelCntId) {
-					std::uint32_t* lctntdata = tempTwo.data();
-					std::int64_t lctntsize = (std::int64_t)sizeof(std::uint32_t);
-
-					std::int64_t lreadContent = stream.read(lctntdata, lctntsize);
-					if (lreadContent != lctntsize)
-						return false;
-
-					// endianness
-					if (endiannessRequired) {
-						std::for_each(lctntdata, lctntdata + 1,
-									  [](std::uint32_t& v) {
-										  v = n2hl(v);
-									  });
-					}
-
-					std::size_t countMapSize = (std::size_t)tempTwo[0];
-					countMapSize <<= 1; // chunks not elements
-
-					if (!countMapSize)
-						return false;
-
-					std::size_t wheere = levelCntId +
-						(std::size_t)(lvl + diff * levelCount) * fcount;
-					ftarget[wheere].resize(countMapSize);
-
-					lctntdata = ftarget[wheere].data();
-					lctntsize = (std::int64_t)sizeof(std::uint32_t) * countMapSize;
-
-					lreadContent = stream.read(lctntdata, lctntsize);
-					if (lreadContent != lctntsize)
-						return false;
-
-					// endianness
-					if (endiannessRequired) {
-						std::for_each(lctntdata, lctntdata + countMapSize,
-									  [](std::uint32_t& v) {
-										  v = n2hl(v);
-									  });
-					}
-
-					std::uintmax_t checkMapSize = 0;
-
-					for (std::size_t ci = 0; ci < countMapSize; ci += 2)
-						checkMapSize += ftarget[wheere][ci];
-
-					if (checkMapSize !=
-						(std::uintmax_t)mapSizes[lvl +
-						(std::size_t)diff * levelCount].x *
-						(std::uintmax_t)mapSizes[lvl +
-						(std::size_t)diff * levelCount].y)
-						return false;
-				}
-
-				return true;
-			};
+			// only the chunk counts are read, the chunks are skipped until loadLevel
+			std::size_t indexFirst = (lvl + (std::size_t)diff * levelCount) * (LevelCountMapCount + ItemCount);
 
-			// map data
-			if (!func(LevelCountMapCount, levelCountMaps))
-				return false;
+			for (int mapId = 0; mapId < LevelCountMapCount + ItemCount; ++mapId) {
+				ctntdata = tempTwo.data();
+				ctntsize = (std::int64_t)sizeof(std::uint32_t);
 
-			// separately probs for items
-			if (!func(ItemCount, itemProbCountMaps))
-				return false;
+				if (!loadFunc())
+					return false;
+
+				if (!tempTwo[0])
+					return false;
+
+				std::int64_t offset = stream.tell();
+				std::int64_t chunksEnd = offset + (std::int64_t)sizeof(std::uint32_t) * 2 * tempTwo[0];
+
+				if (offset < 0 || stream.seek(chunksEnd) != chunksEnd)
+					return false;
+
+				countMapIndex[indexFirst + mapId].offset = offset;
+				countMapIndex[indexFirst + mapId].chunkCount = tempTwo[0];
+			}
 		}
 
 
@@ -226,13 +170,99 @@ bool Levels::loadFromStream(unsigned int diffCount,
 	m_effectDurations.swap(effectDurations);
 	m_powerupProbs.swap(powerupProbs);
 	m_mapSizes.swap(mapSizes);
-	m_levelCountMaps.swap(levelCountMaps);
-	m_itemProbCountMaps.swap(itemProbCountMaps);
+	m_countMapIndex.swap(countMapIndex);
+	m_cache.clear();
+	m_stream = &stream;
+	m_endiannessRequired = endiannessRequired;
 	m_diffCount = diffCount;
 	m_levelCount = levelCount;
 	return true;
 }
 
+bool Levels::loadLevel(unsigned int diffIndex, unsigned int levelIndex) {
+	assert(diffIndex < m_diffCount);
+	assert(levelIndex < m_levelCount);
+
+	std::size_t level = levelIndex + (std::size_t)diffIndex * m_levelCount;
+	++m_useCount;
+
+	for (CachedLevel& cached : m_cache) {
+		if (cached.level == level) {
+			cached.lastUse = m_useCount;
+			return true;
+		}
+	}
+
+	// a free place or the least recently used one (its vectors are reused)
+	CachedLevel* target;
+
+	if (m_cache.size() < CacheCapacity) {
+		target = &m_cache.emplace_back();
+	} else {
+		target = &*std::min_element(m_cache.begin(), m_cache.end(),
+									[](const CachedLevel& left, const CachedLevel& right) {
+										return left.lastUse < right.lastUse;
+									});
+	}
+
+	if (!decodeCountMaps(level, *target)) {
+		// nothing half decoded stays
+		m_cache.erase(m_cache.begin() + (target - m_cache.data()));
+		return false;
+	}
+
+	target->level = level;
+	target->lastUse = m_useCount;
+	return true;
+}
+
+bool Levels::isLevelLoaded(unsigned int diffIndex, unsigned int levelIndex) const noexcept {
+	return findCachedLevel(diffIndex, levelIndex) != nullptr;
+}
+
+const Levels::CachedLevel* Levels::findCachedLevel(unsigned int diffIndex,
+												   unsigned int levelIndex) const noexcept {
+	std::size_t level = levelIndex + (std::size_t)diffIndex * m_levelCount;
+
+	for (const CachedLevel& cached : m_cache)
+		if (cached.level == level)
+			return &cached;
+
+	return nullptr;
+}
+
+bool Levels::decodeCountMaps(std::size_t level, CachedLevel& cached) {
+	constexpr std::size_t mapCount = LevelCountMapCount + ItemCount;
+
+	if (!m_stream)
+		return false;
+
+	std::uintmax_t area = (std::uintmax_t)m_mapSizes[level].x * m_mapSizes[level].y;
+	cached.countMaps.resize(mapCount);
+
+	for (std::size_t mapId = 0; mapId < mapCount; ++mapId) {
+		const CountMapEntry& entry = m_countMapIndex[level * mapCount + mapId];
+		std::vector<std::uint32_t>& countMap = cached.countMaps[mapId];
+
+		std::size_t countMapSize = (std::size_t)entry.chunkCount << 1; // chunks not elements
+		countMap.resize(countMapSize);
+
+		if (m_stream->seek(entry.offset) != entry.offset ||
+			!readN2hl(*m_stream, countMap.data(), countMapSize, m_endiannessRequired))
+			return false;
+
+		std::uintmax_t checkMapSize = 0;
+
+		for (std::size_t ci = 0; ci < countMapSize; ci += 2)
+			checkMapSize += countMap[ci];
+
+		if (checkMapSize != area)
+			return false;
+	}
+
+	return true;
+}
+
 const std::uint32_t*
 Levels::getLevelAttribPtr(unsigned int diffIndex,
 						  unsigned int levelIndex) const noexcept {
@@ -288,12 +318,11 @@ Levels::getLevelCountMap(LevelCountMap what,
 						 unsigned int diffIndex, 
 						 unsigned int levelIndex) const noexcept {
 	assert((int)what >= 0 && what < LevelCountMap::Count);
-	assert(diffIndex < m_diffCount);
-	assert(levelIndex < m_levelCount);
 
-	return m_levelCountMaps[(unsigned)what +
-		(std::size_t)(levelIndex +
-					  diffIndex * m_levelCount) * LevelCountMapCount].data();
+	const CachedLevel* cached = findCachedLevel(diffIndex, levelIndex);
+	assert(cached);
+
+	return cached->countMaps[(unsigned)what].data();
 }
 
 const std::uint32_t*
@@ -301,12 +330,11 @@ Levels::getItemProbCountMap(EatableItem what,
 							unsigned int diffIndex, 
 							unsigned int levelIndex) const noexcept {
 	assert((int)what >= 0 && what < EatableItem::Count);
-	assert(diffIndex < m_diffCount);
-	assert(levelIndex < m_levelCount);
 
-	return m_itemProbCountMaps[(unsigned)what +
-		(std::size_t)(levelIndex +
-					  diffIndex * m_levelCount) * ItemCount].data();
+	const CachedLevel* cached = findCachedLevel(diffIndex, levelIndex);
+	assert(cached);
+
+	return cached->countMaps[LevelCountMapCount + (unsigned)what].data();
 }
 
 }
@@ -60,10 +60,22 @@ enum class EatableItem;
 class Levels {
 public:
 
+    // Levels with the decoded count maps kept at once
+    static constexpr std::size_t CacheCapacity = 4;
+
+    /// Parses the small per level data and indexes the count maps (their offsets in the stream).
+    /// The count maps are read by loadLevel later, so the stream must outlive the levels
+    /// and must not be read by anything else meanwhile.
     [[nodiscard]] bool loadFromStream(unsigned int diffCount,
                                       unsigned int levelCount, sf::InputStream& stream,
                                       bool endiannessRequired);
 
+    /// Decodes the count maps of the level unless they are cached,
+    /// the least recently used level beyond CacheCapacity is dropped.
+    [[nodiscard]] bool loadLevel(unsigned int diffIndex, unsigned int levelIndex);
+
+    bool isLevelLoaded(unsigned int diffIndex, unsigned int levelIndex) const noexcept;
+
     unsigned int getDifficultyCount() const noexcept {
         return m_diffCount;
     }
@@ -82,6 +94,8 @@ public:
     const sf::Vector2u& getMapSize(unsigned int diffIndex,
                                    unsigned int levelIndex) const noexcept;
 
+    // The level must be loaded, the pointers are valid until it is dropped
+
     const std::uint32_t*
         getLevelCountMap(LevelCountMap what, unsigned int diffIndex,
                          unsigned int levelIndex) const noexcept;
@@ -91,6 +105,22 @@ public:
 
 private:
 
+    // Count map chunks in the stream
+    struct CountMapEntry {
+        std::int64_t offset = 0;
+        std::uint32_t chunkCount = 0;
+    };
+
+    struct CachedLevel {
+        std::size_t level = 0; // levelIndex + diffIndex * levelCount
+        std::uint64_t lastUse = 0;
+        std::vector<std::vector<std::uint32_t>> countMaps; // as m_countMapIndex
+    };
+
+    const CachedLevel* findCachedLevel(unsigned int diffIndex, unsigned int levelIndex) const noexcept;
+
+    [[nodiscard]] bool decodeCountMaps(std::size_t level, CachedLevel& cached);
+
     std::vector<std::uint32_t> m_levelAttributes;
     std::vector<std::uint32_t> m_levelPlotData;
     std::vector<std::uint32_t> m_effectDurations;
@@ -99,8 +129,14 @@ private:
         fwkGetRealSizeLvl<std::size_t, int>(PowerupCount)>> m_powerupProbs;
 
     std::vector<sf::Vector2u> m_mapSizes;
-    std::vector<std::vector<std::uint32_t>> m_levelCountMaps;
-    std::vector<std::vector<std::uint32_t>> m_itemProbCountMaps;
+
+    // LevelCountMapCount level maps then ItemCount item probability maps per level
+    std::vector<CountMapEntry> m_countMapIndex;
+    std::vector<CachedLevel> m_cache;
+    std::uint64_t m_useCount = 0;
+
+    sf::InputStream* m_stream = nullptr;
+    bool m_endiannessRequired = false;
 
     unsigned int m_diffCount = 0;
     unsigned int m_levelCount = 0;
@@ -42,18 +42,9 @@ ObjectBehaviorLoader::loadFromStream(std::vector<ObjectBehavior>& objBehvrs,
     std::array<std::uint32_t, ObjectKeywordCount> objectKwMap{};
     std::int64_t finstatus;
 
-    finstatus = stream.read(objectKwMap.data(), sizeof(std::uint32_t) * ObjectKeywordCount);
-    if (finstatus != sizeof(std::uint32_t) * ObjectKeywordCount)
+    if (!readN2hl(stream, objectKwMap.data(), objectKwMap.size(), endiannessRequired))
         return "Object behavior keyword map opening failure";
 
-    // endianness
-    if (endiannessRequired) {
-        std::for_each(objectKwMap.begin(), objectKwMap.end(),
-                      [](std::uint32_t& v) {
-                          v = n2hl(v);
-                      });
-    }
-
     // TODO: check the kw map
     std::unordered_map<std::uint32_t, ObjectBehaviorKeyword> objectKwRevMap;
 
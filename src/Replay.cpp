@@ -0,0 +1,333 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include "Replay.hpp"
+#include "Game.hpp"
+#include <bw_ext/stream/OutputStream.hpp>
+#include <SFML/System/InputStream.hpp>
+#include <limits>
+
+namespace {
+
+void writeVarint(std::vector<std::uint8_t>& bytes, std::uint64_t value) {
+    while (value >= 0x80) {
+        bytes.push_back((std::uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back((std::uint8_t)value);
+}
+
+
+// the time deltas are signed
+void writeSignedVarint(std::vector<std::uint8_t>& bytes, std::int64_t value) {
+    writeVarint(bytes, ((std::uint64_t)value << 1) ^ (std::uint64_t)(value >> 63));
+}
+
+
+// a hash gains nothing from a varint
+void writeFixed64(std::vector<std::uint8_t>& bytes, std::uint64_t value) {
+    for (int shift = 56; shift >= 0; shift -= 8)
+        bytes.push_back((std::uint8_t)(value >> shift));
+}
+
+
+class ByteReader {
+public:
+
+    ByteReader(const std::uint8_t* data, std::size_t size) noexcept :
+        m_data(data), m_end(data + size) {}
+
+    [[nodiscard]] bool readVarint(std::uint64_t& value) noexcept {
+        value = 0;
+
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (m_data == m_end)
+                return false;
+
+            std::uint8_t byte = *m_data++;
+            value |= (std::uint64_t)(byte & 0x7F) << shift;
+
+            if (!(byte & 0x80))
+                return true;
+        }
+
+        return false;
+    }
+
+    [[nodiscard]] bool readSignedVarint(std::int64_t& value) noexcept {
+        std::uint64_t encoded = 0;
+        if (!readVarint(encoded))
+            return false;
+
+        value = (std::int64_t)(encoded >> 1) ^ -(std::int64_t)(encoded & 1);
+        return true;
+    }
+
+    [[nodiscard]] bool readFixed64(std::uint64_t& value) noexcept {
+        if (m_end - m_data < 8)
+            return false;
+
+        value = 0;
+        for (int i = 0; i < 8; ++i)
+            value = (value << 8) | *m_data++;
+
+        return true;
+    }
+
+    [[nodiscard]] bool readByte(std::uint8_t& value) noexcept {
+        if (m_data == m_end)
+            return false;
+
+        value = *m_data++;
+        return true;
+    }
+
+    bool atEnd() const noexcept {
+        return m_data == m_end;
+    }
+
+private:
+
+    const std::uint8_t* m_data;
+    const std::uint8_t* m_end;
+};
+
+
+std::uint64_t mix(std::uint64_t hash, std::uint64_t value) noexcept {
+    hash ^= value;
+    hash *= 0x9E3779B97F4A7C15ull;
+    return hash ^ (hash >> 29);
+}
+
+
+std::uint64_t packPosition(const sf::Vector2i& position) noexcept {
+    return ((std::uint64_t)(std::uint32_t)position.x << 32) | (std::uint32_t)position.y;
+}
+
+}
+
+namespace Bulletworm {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+std::uint64_t Replay::hashState(std::uint64_t hash, const SnakeWorld& world) noexcept {
+    hash = mix(hash, packPosition(world.getCurrentSnakePosition()));
+    hash = mix(hash, packPosition(world.getBackPosition()));
+    hash = mix(hash, world.getStepCount());
+    hash = mix(hash, world.getTailSize());
+
+    for (const sf::Vector2i& fruit : world.getFruitPositions())
+        hash = mix(hash, packPosition(fruit));
+
+    for (const sf::Vector2i& bonus : world.getBonusPositions())
+        hash = mix(hash, packPosition(bonus) ^ 1);
+
+    for (const SnakeWorld::PowerupPosition& powerup : world.getPowerups())
+        hash = mix(hash, packPosition(powerup.first) ^ ((std::uint64_t)powerup.second << 1));
+
+    return hash;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+bool Replay::saveToStream(OutputStream& stream) const {
+    std::vector<std::uint8_t> bytes;
+    bytes.reserve(32 + records.size() * 3);
+
+    writeVarint(bytes, Version);
+    writeVarint(bytes, seed);
+    writeVarint(bytes, difficulty);
+    writeVarint(bytes, levelIndex);
+    writeVarint(bytes, hashInterval);
+    writeVarint(bytes, records.size());
+
+    std::int64_t previousTime = 0;
+
+    for (const Record& record : records) {
+        bytes.push_back((std::uint8_t)((std::uint8_t)record.type | ((std::uint8_t)record.direction << 2)));
+        writeSignedVarint(bytes, record.time - previousTime);
+        previousTime = record.time;
+
+        if (record.type != RecordType::Command)
+            writeFixed64(bytes, record.hash);
+    }
+
+    return stream.write(bytes.data(), (std::int64_t)bytes.size()) == (std::int64_t)bytes.size();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+std::optional<std::string> Replay::loadFromStream(sf::InputStream& stream) {
+    std::int64_t size = stream.getSize();
+    if (size <= 0)
+        return "Empty replay";
+
+    std::vector<std::uint8_t> bytes((std::size_t)size);
+    if (stream.read(bytes.data(), size) != size)
+        return "Failed to read the replay";
+
+    ByteReader reader(bytes.data(), bytes.size());
+
+    std::uint64_t version = 0;
+    std::uint64_t newDifficulty = 0;
+    std::uint64_t newLevelIndex = 0;
+    std::uint64_t recordCount = 0;
+    Replay replay;
+
+    if (!reader.readVarint(version) || version != Version)
+        return "Unsupported replay version";
+
+    if (!reader.readVarint(replay.seed) ||
+        !reader.readVarint(newDifficulty) ||
+        !reader.readVarint(newLevelIndex) ||
+        !reader.readVarint(replay.hashInterval) ||
+        !reader.readVarint(recordCount))
+        return "Truncated replay header";
+
+    // at least 2 bytes per record
+    if (newDifficulty > std::numeric_limits<std::uint32_t>::max() ||
+        newLevelIndex > std::numeric_limits<std::uint32_t>::max() ||
+        recordCount > bytes.size() / 2)
+        return "Corrupted replay header";
+
+    replay.difficulty = (std::uint32_t)newDifficulty;
+    replay.levelIndex = (std::uint32_t)newLevelIndex;
+    replay.records.resize((std::size_t)recordCount);
+
+    std::int64_t previousTime = 0;
+
+    for (Record& record : replay.records) {
+        std::uint8_t typeAndDirection = 0;
+        std::int64_t timeDelta = 0;
+
+        if (!reader.readByte(typeAndDirection) || !reader.readSignedVarint(timeDelta))
+            return "Truncated replay record";
+
+        std::uint8_t type = typeAndDirection & 3;
+        std::uint8_t direction = typeAndDirection >> 2;
+
+        if (type >= (std::uint8_t)RecordType::Count || direction >= DirectionCount)
+            return "Corrupted replay record";
+
+        record.type = (RecordType)type;
+        record.direction = (Direction)direction;
+        record.time = previousTime + timeDelta;
+        previousTime = record.time;
+
+        if (record.type != RecordType::Command && !reader.readFixed64(record.hash))
+            return "Truncated replay record";
+    }
+
+    if (!reader.atEnd())
+        return "Trailing bytes in the replay";
+
+    *this = std::move(replay);
+    return std::nullopt;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void ReplayRecorder::start(std::uint64_t seed, std::uint32_t difficulty, std::uint32_t levelIndex,
+                           std::uint64_t hashInterval) {
+    m_replay.seed = seed;
+    m_replay.difficulty = difficulty;
+    m_replay.levelIndex = levelIndex;
+    m_replay.hashInterval = hashInterval;
+    m_replay.records.clear();
+
+    m_hash = 0;
+    m_nextCheckpointStep = (hashInterval ? hashInterval : std::numeric_limits<std::uint64_t>::max());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void ReplayRecorder::recordCommand(std::int64_t now, Direction direction) {
+    Replay::Record record;
+    record.type = Replay::RecordType::Command;
+    record.direction = direction;
+    record.time = now;
+    m_replay.records.push_back(record);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void ReplayRecorder::recordUpdate(const Game& game) {
+    std::uint64_t steps = game.getImpl().getSnakeWorld().getStepCount();
+
+    if (steps >= m_nextCheckpointStep) {
+        addCheckpoint(Replay::RecordType::Checkpoint, game);
+        m_nextCheckpointStep = steps - steps % m_replay.hashInterval + m_replay.hashInterval;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void ReplayRecorder::finish(const Game& game) {
+    addCheckpoint(Replay::RecordType::End, game);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void ReplayRecorder::addCheckpoint(Replay::RecordType type, const Game& game) {
+    m_hash = Replay::hashState(m_hash, game.getImpl().getSnakeWorld());
+
+    Replay::Record record;
+    record.type = type;
+    record.time = game.getTime();
+    record.hash = m_hash;
+    m_replay.records.push_back(record);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+ReplayPlayer::Result ReplayPlayer::play(const Replay& replay, Game& game) {
+    Result result;
+    std::uint64_t hash = 0;
+
+    for (std::size_t i = 0; i < replay.records.size(); ++i) {
+        const Replay::Record& record = replay.records[i];
+
+        // the queued commands are applied in time order by the next update
+        if (record.type == Replay::RecordType::Command) {
+            game.pushCommand(record.time, record.direction);
+            continue;
+        }
+
+        game.fastForward(record.time);
+
+        hash = Replay::hashState(hash, game.getImpl().getSnakeWorld());
+        ++result.checkpoints;
+
+        if (hash != record.hash) {
+            result.diverged = true;
+            result.divergedRecord = i;
+            break;
+        }
+    }
+
+    result.steps = game.getImpl().getSnakeWorld().getStepCount();
+    return result;
+}
+
+} // namespace Bulletworm
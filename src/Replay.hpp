@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+#include <bw_ext/const/ObjectParameterEnums.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace sf {
+class InputStream;
+}
+
+namespace Bulletworm {
+
+class OutputStream;
+class Game;
+class SnakeWorld;
+
+/// Everything that reproduces a game bit-exactly:
+/// the seed of the engine randomizers, the level and the pushed commands.
+/// The checkpoints carry a rolling hash of the SnakeWorld state to detect a divergence.
+class Replay {
+public:
+
+    static constexpr std::uint32_t Version = 2;     // 2: xoshiro256** streams
+
+    enum class RecordType : std::uint8_t {
+        Command,      // Game::pushCommand(time, direction)
+        Checkpoint,   // the state has been updated to the time, the hash is taken
+        End,          // the last checkpoint
+
+        Count
+    };
+
+    struct Record {
+        RecordType type = RecordType::Command;
+        Direction direction = Direction::Up;   // Command
+        std::int64_t time = 0;
+        std::uint64_t hash = 0;                // Checkpoint and End
+    };
+
+    /// Chain the state of the world to the hash (head, back, step count, tail size, items)
+    static std::uint64_t hashState(std::uint64_t hash, const SnakeWorld& world) noexcept;
+
+    /// Varint / delta encoded
+    [[nodiscard]] bool saveToStream(OutputStream& stream) const;
+    [[nodiscard]] std::optional<std::string> loadFromStream(sf::InputStream& stream);
+
+    std::uint64_t seed = 0;            // RandomizerImpl::seedStreams seed set just before Game::restart
+    std::uint32_t difficulty = 0;
+    std::uint32_t levelIndex = 0;
+    std::uint64_t hashInterval = 0;    // steps between the checkpoints
+    std::vector<Record> records;       // in the call order
+};
+
+
+/// Watches a game being played.
+/// Call recordCommand along with Game::pushCommand and recordUpdate after Game::update.
+class ReplayRecorder {
+public:
+
+    static constexpr std::uint64_t DefaultHashInterval = 64;
+
+    /// The randomizers of the game must be seeded with RandomizerImpl::seedStreams
+    /// (one stream per RandomizerType) just before its restart
+    void start(std::uint64_t seed, std::uint32_t difficulty, std::uint32_t levelIndex,
+               std::uint64_t hashInterval = DefaultHashInterval);
+
+    void recordCommand(std::int64_t now, Direction direction);
+
+    /// Adds a checkpoint if another hashInterval steps are made
+    void recordUpdate(const Game& game);
+
+    /// Adds the End checkpoint
+    void finish(const Game& game);
+
+    const Replay& getReplay() const noexcept {
+        return m_replay;
+    }
+
+private:
+
+    void addCheckpoint(Replay::RecordType type, const Game& game);
+
+    Replay m_replay;
+    std::uint64_t m_hash = 0;
+    std::uint64_t m_nextCheckpointStep = 0;
+};
+
+
+/// Re-drives a game by a replay as fast as possible (no event is built).
+class ReplayPlayer {
+public:
+
+    struct Result {
+        std::uint64_t steps = 0;          // SnakeWorld step count at the end
+        std::size_t checkpoints = 0;      // the compared ones
+        bool diverged = false;
+        std::size_t divergedRecord = 0;   // the first checkpoint with another hash
+    };
+
+    /// The game must be restarted for the replay level
+    /// with the randomizers seeded with replay.seed just before (see ReplayRecorder::start).
+    /// Stops on the first divergence.
+    static Result play(const Replay& replay, Game& game);
+};
+
+} // namespace Bulletworm
+
+#endif // !REPLAY_HPP
@@ -34,18 +34,14 @@
 #include <cassert>
 
 namespace {
-template<class Vec>
-sf::Vector2i getRandomPosition(const Vec& probMap,
+sf::Vector2i getRandomPosition(const Bulletworm::FenwickSampler<1>& probMap,
                                const sf::Vector2u& mapSize,
                                Bulletworm::Randomizer& randomizer) {
-    using fwt = Bulletworm::FenwickTree<typename Vec::iterator,
-        typename Vec::const_iterator, std::ptrdiff_t, std::uintmax_t>;
-
-    std::uintmax_t modulo = fwt::getSum(probMap.begin(), probMap.size() - 1);
+    std::uintmax_t modulo = probMap.getTotal(0);
     if (!modulo) return sf::Vector2i(mapSize);
 
     std::uintmax_t random = randomizer.get(0, modulo - 1);
-    std::size_t target = fwt::rankQuery(probMap.begin(), probMap.end(), random);
+    std::size_t target = probMap.rankQuery(0, random);
 
     sf::Vector2i result;
     result.x = int(target % (std::size_t)mapSize.x);
@@ -62,6 +58,11 @@ GameImpl::GameImpl(GameImpl&& src) noexcept :
     m_randomizers(std::move(src.m_randomizers)),
     m_intiItemProbs(std::move(src.m_intiItemProbs)),
     m_objectMemory(std::move(src.m_objectMemory)),
+    m_objectMemoryJournal(std::move(src.m_objectMemoryJournal)),
+    m_objectMemorySource(src.m_objectMemorySource),
+    m_objectMemoryUndo(std::move(src.m_objectMemoryUndo)),
+    m_trailing(src.m_trailing),
+    m_quickRestart(src.m_quickRestart),
     m_aimedTailSize(src.m_aimedTailSize),
     m_harmlessLessStepID(src.m_harmlessLessStepID),
     m_snakeDirection(src.m_snakeDirection),
@@ -75,6 +76,8 @@ GameImpl::GameImpl(GameImpl&& src) noexcept :
     src.m_levelPtrs = LevelPointers{};
     src.m_randomizers.fill(nullptr);
     src.m_snakeIsAlive = false;
+    src.m_quickRestart = false;
+    src.m_trailing = false;
 }
 
 
@@ -91,6 +94,11 @@ GameImpl& GameImpl::operator=(GameImpl&& src) noexcept {
     m_intiItemProbs = std::move(src.m_intiItemProbs);
     m_levelPtrs = src.m_levelPtrs;
     m_objectMemory = std::move(src.m_objectMemory);
+    m_objectMemoryJournal = std::move(src.m_objectMemoryJournal);
+    m_objectMemorySource = src.m_objectMemorySource;
+    m_objectMemoryUndo = std::move(src.m_objectMemoryUndo);
+    m_trailing = src.m_trailing;
+    m_quickRestart = src.m_quickRestart;
     m_randomizers = std::move(src.m_randomizers);
     m_snakeDirection = src.m_snakeDirection;
     m_snakeIsAlive = src.m_snakeIsAlive;
@@ -101,6 +109,8 @@ GameImpl& GameImpl::operator=(GameImpl&& src) noexcept {
     src.m_levelPtrs = LevelPointers{};
     src.m_randomizers.fill(nullptr);
     src.m_snakeIsAlive = false;
+    src.m_quickRestart = false;
+    src.m_trailing = false;
 
     return *this;
 }
@@ -127,10 +137,9 @@ void GameImpl::reset(const LevelPointers& ptrs,
     std::copy(itemProbs, itemProbs + ItemCount, m_intiItemProbs.begin());
 
     assert(ptrs.attribArray);
+    assert(ptrs.cells);
     assert(ptrs.effectDurations);
     assert(ptrs.objectBehs);
-    assert(ptrs.objectPairIndices);
-    assert(ptrs.objectParams);
     assert(ptrs.postEffectBehIndices);
     assert(ptrs.powerupProbs);
     assert(ptrs.preEffectBehIndices);
@@ -138,30 +147,100 @@ void GameImpl::reset(const LevelPointers& ptrs,
     assert(ptrs.tailCapacities1);
 
     m_levelPtrs = ptrs;
+    m_quickRestart = false;
     restart(objectMemory);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void GameImpl::buildCellRecords(const LevelPointers& ptrs,
+                                std::size_t objectPairCount,
+                                const RunLengthMap& objectPairIndices,
+                                const RunLengthMap& objectParams,
+                                const RunLengthMap* themes,
+                                GridLayout layout,
+                                CellGrid<CellRecord>& cells) {
+    assert(ptrs.objectBehs);
+    assert(ptrs.postEffectBehIndices);
+    assert(ptrs.preEffectBehIndices);
+    assert(ptrs.tailCapacities1);
+    assert(objectParams.getSize() == objectPairIndices.getSize());
+    assert(!themes || themes->getSize() == objectPairIndices.getSize());
+
+    const sf::Vector2u& mapSize = objectPairIndices.getSize();
+
+    std::vector<std::uint8_t> pairEffects(objectPairCount);
+
+    for (std::size_t i = 0; i < objectPairCount; ++i) {
+        if (!ptrs.objectBehs[ptrs.preEffectBehIndices[i]].isInert())
+            pairEffects[i] |= std::uint8_t(1u << (int)ObjectEffect::Pre);
+
+        if (!ptrs.objectBehs[ptrs.postEffectBehIndices[i]].isInert())
+            pairEffects[i] |= std::uint8_t(1u << (int)ObjectEffect::Post);
+    }
+
+    cells.create(mapSize, layout);
+
+    // row-major as the chunks
+    RunLengthMap::Reader pairReader = objectPairIndices.getReader();
+    RunLengthMap::Reader paramReader = objectParams.getReader();
+    RunLengthMap::Reader themeReader = themes ? themes->getReader() : RunLengthMap::Reader(nullptr);
+
+    for (unsigned int y = 0; y < mapSize.y; ++y) {
+        for (unsigned int x = 0; x < mapSize.x; ++x) {
+            std::uint32_t pair = pairReader.next();
+            CellRecord& record = cells.at((int)x, (int)y);
+
+            record.objectParam = paramReader.next();
+            record.tailCapacity1 = ptrs.tailCapacities1[pair];
+            record.objectPair = (std::uint16_t)pair;
+            record.activeEffects = pairEffects[pair];
+            record.theme = (std::uint8_t)(themes ? themeReader.next() : 0);
+        }
+    }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 void GameImpl::restart(const std::uint32_t* objectMemory) {
+    m_objectMemoryUndo.clear();
+    m_trailing = false;
+
     sf::Vector2i snakePos =
         getRandomPosition(*m_levelPtrs.snakePositionProbs,
                           m_intiItemProbs.front()->getSize(),
                           useRandomizer(RandomizerType::Position));
 
-    m_snakeWorld.restart(m_intiItemProbs.data(), snakePos);
+    if (m_quickRestart)
+        m_snakeWorld.restart(snakePos);
+    else
+        m_snakeWorld.restart(m_intiItemProbs.data(), snakePos);
 
     for (std::uint32_t i = 0; i < getLevelAttribute(LevelAttribEnum::FruitCount); ++i)
         m_snakeWorld.placeFruit(*m_randomizers[(std::size_t)RandomizerType::Position]);
 
-    if (objectMemory) {
-        m_objectMemory.assign(objectMemory, objectMemory + (std::size_t)getSnakeWorld().getMapSize().x *
-                              getSnakeWorld().getMapSize().y);
+    std::size_t area = (std::size_t)getSnakeWorld().getMapSize().x * getSnakeWorld().getMapSize().y;
+
+    if (m_quickRestart && objectMemory == m_objectMemorySource &&
+        !m_objectMemoryJournal.isOverflowed()) {
+        // revert the touched cells only
+        for (std::uint32_t cell : m_objectMemoryJournal.getCells())
+            m_objectMemory[cell] = (objectMemory ? objectMemory[cell] : 0);
+
+        m_objectMemoryJournal.clear();
     } else {
-        m_objectMemory.clear();
-        m_objectMemory.resize((std::size_t)getSnakeWorld().getMapSize().x *
-                              getSnakeWorld().getMapSize().y);
+        if (objectMemory) {
+            m_objectMemory.assign(objectMemory, objectMemory + area);
+        } else {
+            m_objectMemory.clear();
+            m_objectMemory.resize(area);
+        }
+
+        m_objectMemoryJournal.create(area, area / 8 + 64);
     }
 
+    m_objectMemorySource = objectMemory;
+    m_quickRestart = true;
+
     // reset some states
     m_snakeDirection = Direction::Count;
     m_harmlessLessStepID = 0;
@@ -314,21 +393,14 @@ std::uintmax_t GameImpl::move() {
     // kill by tail
 
     if (!notNeedToTestTail) {
-        unsigned int width = m_intiItemProbs.front()->getSize().x;
-        const auto& tailId = m_snakeWorld.getTailIDs(currentSnakePosition);
-
-        std::size_t tailElementFound = tailId.size();
-
-        // without harmless'es
-        std::size_t harmfullElementFound = tailElementFound;
-        for (auto now = tailId.begin(); now != tailId.end(); ++now) {
-            if (now->first < m_harmlessLessStepID) --harmfullElementFound;
-            else break;
-        }
+        // without harmless'es (the IDs are ascending)
+        std::size_t harmfullElementFound = 0;
+        for (const auto& now : m_snakeWorld.getTailIDs(currentSnakePosition))
+            if (now.first >= m_harmlessLessStepID)
+                ++harmfullElementFound;
 
         std::size_t freedom =
-            (std::size_t)m_levelPtrs.tailCapacities1[m_levelPtrs.objectPairIndices[currentSnakePosition.x +
-            currentSnakePosition.y * width]] - 1;
+            (std::size_t)m_levelPtrs.cells->at(currentSnakePosition).tailCapacity1 - 1;
 
         // Check some reasons for staying alive
         bool ordinaryReason = (harmfullElementFound <= freedom);
@@ -376,12 +448,15 @@ void GameImpl::objectEffect(ObjectEffect effect) {
     sf::Vector2i currSnakePos = m_snakeWorld.getCurrentSnakePosition();
     bool preEffect = (effect == ObjectEffect::Pre);
 
-    std::uint32_t param = m_levelPtrs.objectParams[currSnakePos.x +
-        currSnakePos.y * m_intiItemProbs.front()->getSize().x];
+    const CellRecord& cell = m_levelPtrs.cells->at(currSnakePos);
+
+    // Void cells mostly: activate would change nothing
+    if (!(cell.activeEffects & (1u << (int)effect)))
+        return;
 
     // Fill arguments
     ObjectBehavior::ExecutionArguments arguments;
-    arguments.parameter = param;
+    arguments.parameter = cell.objectParam;
     arguments.previousSnakeDirection = m_snakeWorld.getPreviousDirection();
     arguments.randomizer = &useRandomizer(RandomizerType::Behavior);
 
@@ -396,11 +471,8 @@ void GameImpl::objectEffect(ObjectEffect effect) {
     // Activate!
 
     {
-        std::int64_t tmp1 = currSnakePos.x + (std::int64_t)currSnakePos.y * m_intiItemProbs.front()->getSize().x;
-        std::uint32_t tmp2 = m_levelPtrs.objectPairIndices[tmp1];
-        const std::uint32_t* tmp3 = (preEffect ? m_levelPtrs.preEffectBehIndices : m_levelPtrs.postEffectBehIndices);
-        std::uint32_t tmp4 = tmp3[tmp2];
-        const ObjectBehavior& currentBehavior = m_levelPtrs.objectBehs[tmp4];
+        const std::uint32_t* behIndices = (preEffect ? m_levelPtrs.preEffectBehIndices : m_levelPtrs.postEffectBehIndices);
+        const ObjectBehavior& currentBehavior = m_levelPtrs.objectBehs[behIndices[cell.objectPair]];
 
         currentBehavior.activate(target, arguments);
     }
@@ -411,8 +483,17 @@ void GameImpl::objectEffect(ObjectEffect effect) {
     m_snakeIsMoving = target.moving;
     m_snakeIsAlive = target.alive;
 
-    m_objectMemory[(std::size_t)currSnakePos.x +
-        (std::size_t)currSnakePos.y * getSnakeWorld().getMapSize().x] = target.remembered;
+    std::size_t memoryIndex = (std::size_t)currSnakePos.x +
+        (std::size_t)currSnakePos.y * getSnakeWorld().getMapSize().x;
+
+    if (m_objectMemory[memoryIndex] != target.remembered) {
+        m_objectMemoryJournal.mark(memoryIndex);
+
+        if (m_trailing)
+            m_objectMemoryUndo.push(memoryIndex, m_objectMemory[memoryIndex]);
+
+        m_objectMemory[memoryIndex] = target.remembered;
+    }
 }
 
 
@@ -439,6 +520,59 @@ void GameImpl::pushCommand(Direction rotateCommand) noexcept {
 }
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void GameImpl::setRandomizers(Randomizer* const* randomizers) noexcept {
+    std::copy(randomizers, randomizers + RandomTypeCount, m_randomizers.begin());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+GameImpl::Snapshot GameImpl::takeSnapshot() noexcept {
+    m_trailing = true;
+
+    Snapshot snapshot;
+    snapshot.world = m_snakeWorld.takeSnapshot();
+    snapshot.objectMemoryMark = m_objectMemoryUndo.getMark();
+    snapshot.aimedTailSize = m_aimedTailSize;
+    snapshot.harmlessLessStepID = m_harmlessLessStepID;
+    snapshot.snakeDirection = m_snakeDirection;
+    snapshot.acceleration = m_acceleration;
+    snapshot.effect = m_effect;
+    snapshot.fruitCountToBonus = m_fruitCountToBonus;
+    snapshot.bonusCountToPowerup = m_bonusCountToPowerup;
+    snapshot.snakeIsMoving = m_snakeIsMoving;
+    snapshot.snakeIsAlive = m_snakeIsAlive;
+    return snapshot;
+}
+
+
+void GameImpl::restoreSnapshot(const Snapshot& snapshot) {
+    m_snakeWorld.restoreSnapshot(snapshot.world);
+
+    // the restart journal keeps the marks, they are still the touched cells
+    m_objectMemoryUndo.rewind(snapshot.objectMemoryMark, [this](std::size_t index, std::uint32_t value) {
+        m_objectMemory[index] = value;
+    });
+
+    m_aimedTailSize = snapshot.aimedTailSize;
+    m_harmlessLessStepID = snapshot.harmlessLessStepID;
+    m_snakeDirection = snapshot.snakeDirection;
+    m_acceleration = snapshot.acceleration;
+    m_effect = snapshot.effect;
+    m_fruitCountToBonus = snapshot.fruitCountToBonus;
+    m_bonusCountToPowerup = snapshot.bonusCountToPowerup;
+    m_snakeIsMoving = snapshot.snakeIsMoving;
+    m_snakeIsAlive = snapshot.snakeIsAlive;
+}
+
+
+void GameImpl::dropSnapshots() noexcept {
+    m_snakeWorld.dropSnapshots();
+    m_objectMemoryUndo.clear();
+    m_trailing = false;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 std::intmax_t GameImpl::getFactualSnakePeriod() const noexcept {
     std::int64_t period = getLevelAttribute(LevelAttribEnum::SnakePeriod);
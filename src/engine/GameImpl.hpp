@@ -26,6 +26,8 @@
 #ifndef GAME_IMPL_HPP
 #define GAME_IMPL_HPP
 #include "SnakeWorld.hpp"
+#include <bw_ext/CellGrid.hpp>
+#include <bw_ext/RunLengthMap.hpp>
 #include "const/MiscEnum.hpp"
 
 /// Note that Snake has the factual direction when the snake
@@ -63,11 +65,21 @@ class GameImpl {
 
 public:
 
+    /// Read-only per cell data of the level packed together,
+    /// a move reads one record instead of a cell of several parallel arrays
+    struct CellRecord {
+        std::uint32_t objectParam = 0;
+        std::uint32_t tailCapacity1 = 0;   // of the object pair
+        std::uint16_t objectPair = 0;
+        std::uint8_t activeEffects = 0;    // bit (1 << ObjectEffect) if the behavior is not inert
+        std::uint8_t theme = 0;            // drawing only
+    };
+
     struct LevelPointers {
         // single
 
         const std::array<std::uintmax_t, fwkGetRealSize<std::size_t, int>(PowerupCount)>* powerupProbs = nullptr;
-        const std::vector<std::uintmax_t>* snakePositionProbs = nullptr;
+        const FenwickSampler<1>* snakePositionProbs = nullptr;
 
         // arrays
 
@@ -76,12 +88,26 @@ public:
         const std::uint32_t* postEffectBehIndices = nullptr;
         const std::uint32_t* tailCapacities1 = nullptr;
 
-        const std::uint32_t* objectPairIndices = nullptr;
-        const std::uint32_t* objectParams = nullptr;
+        const CellGrid<CellRecord>* cells = nullptr;  // see buildCellRecords
         const std::uint32_t* effectDurations = nullptr;
         const std::uint32_t* attribArray = nullptr;
     };
 
+    /// The state of a game at some moment, see takeSnapshot
+    struct Snapshot {
+        SnakeWorld::Snapshot world;
+        std::size_t objectMemoryMark = 0;
+        std::uintmax_t aimedTailSize = 0;
+        std::uintmax_t harmlessLessStepID = 0;
+        Direction snakeDirection = Direction::Count;
+        Acceleration acceleration = Acceleration::Default;
+        EffectTypeAl effect = EffectTypeAl::NoEffect;
+        unsigned int fruitCountToBonus = 0;
+        unsigned int bonusCountToPowerup = 0;
+        bool snakeIsMoving = false;
+        bool snakeIsAlive = false;
+    };
+
     GameImpl(const GameImpl&) = default;
     GameImpl(GameImpl&&) noexcept;
 
@@ -102,8 +128,21 @@ public:
                const std::uint32_t* objectMemory,
                Map<std::uint32_t> const* const* itemProbs);
 
+    /// Packs the level count maps into the records without expanding them.
+    /// Requires objectBehs, preEffectBehIndices, postEffectBehIndices and tailCapacities1;
+    /// themes may be nullptr.
+    static void buildCellRecords(const LevelPointers& ptrs,
+                                 std::size_t objectPairCount,
+                                 const RunLengthMap& objectPairIndices,
+                                 const RunLengthMap& objectParams,
+                                 const RunLengthMap* themes,
+                                 GridLayout layout,
+                                 CellGrid<CellRecord>& cells);
+
            // Controlling
 
+    // The same level: only the positions touched since the previous restart are reverted
+    // (the level data must not change, use reset for another level).
     void restart(const std::uint32_t* objectMemory);
 
     /// Kill the snake and stop the game
@@ -118,6 +157,21 @@ public:
     std::uintmax_t move();
     void pushCommand(Direction rotateCommand) noexcept;
 
+    // Snapshots
+
+    /// O(1): from now on the changes are recorded, restoreSnapshot undoes them
+    /// in O(changes) (rewinding, lookahead branches). Snapshots nest: restoring
+    /// an older one invalidates the newer ones. The randomizers are not a part
+    /// of the game, copy their states together with the snapshot if needed.
+    [[nodiscard]] Snapshot takeSnapshot() noexcept;
+    void restoreSnapshot(const Snapshot& snapshot);
+
+    /// Invalidates all the snapshots and stops recording, restart does it too
+    void dropSnapshots() noexcept;
+
+    /// A copy shares the randomizers of the source, point it to its own ones
+    void setRandomizers(Randomizer* const* randomizers) noexcept;
+
     // Getters
 
     const Randomizer* getRandomizer(RandomizerType what) const noexcept;
@@ -168,6 +222,11 @@ public:
         return m_snakeWorld;
     }
 
+    /// The tail grows (or shrinks) to it step by step
+    std::uintmax_t getAimedTailSize() const noexcept {
+        return m_aimedTailSize;
+    }
+
     std::uintmax_t getHarmlessLessStepID() const noexcept {
         return m_harmlessLessStepID;
     }
@@ -204,6 +263,13 @@ private:
 
     // For detecting activated spikes
     std::vector<std::uint32_t> m_objectMemory;
+    CellJournal m_objectMemoryJournal; // Changed object memory since the restart
+    const std::uint32_t* m_objectMemorySource = nullptr; // Restarted with
+    UndoTrail<std::uint32_t> m_objectMemoryUndo; // Overwritten object memory since the oldest snapshot
+    bool m_trailing = false;
+
+    // The previous restart was on the same level
+    bool m_quickRestart = false;
 
     std::uintmax_t m_aimedTailSize = 0;
 
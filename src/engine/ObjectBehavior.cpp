@@ -27,9 +27,417 @@
 #include <bw_ext/random/Randomizer.hpp>
 #include <bw_ext/const/ObjectParameterEnums.hpp>
 #include <bw_ext/ObjParamEnumUtility.hpp>
-#include <forward_list>
+#include <algorithm>
+#include <array>
 #include <cassert>
 
+namespace {
+
+using namespace Bulletworm;
+
+using ExecutionTarget = ObjectBehavior::ExecutionTarget;
+using ExecutionArguments = ObjectBehavior::ExecutionArguments;
+
+// Each keyword is one handler of the threaded code: it takes the top of the value stack
+// (the stack grows up) and returns the new top. 'operand' is decoded at compile().
+using Handler = std::uint32_t* (*)(std::uint32_t* top, std::uint32_t operand,
+                                   const ExecutionTarget& target,
+                                   const ExecutionArguments& arguments);
+
+#define BW_OBJECT_HANDLER(name) \
+std::uint32_t* name([[maybe_unused]] std::uint32_t* top, [[maybe_unused]] std::uint32_t operand, \
+                    [[maybe_unused]] const ExecutionTarget& target, \
+                    [[maybe_unused]] const ExecutionArguments& arguments)
+
+BW_OBJECT_HANDLER(pushOperand) {
+    *++top = operand;
+    return top;
+}
+
+BW_OBJECT_HANDLER(pushAccelerationDefault) {
+    *++top = (std::uint32_t)Acceleration::Default;
+    return top;
+}
+
+BW_OBJECT_HANDLER(pushAccelerationDown) {
+    *++top = (std::uint32_t)Acceleration::Down;
+    return top;
+}
+
+BW_OBJECT_HANDLER(pushAccelerationUp) {
+    *++top = (std::uint32_t)Acceleration::Up;
+    return top;
+}
+
+BW_OBJECT_HANDLER(pushRandomAcceleration) {
+    *++top = (std::uint32_t)arguments.randomizer->get(0, (std::uint64_t)AccelerationCount - 1);
+    return top;
+}
+
+BW_OBJECT_HANDLER(pushRandomCombinedDirection) {
+    *++top = (std::uint32_t)arguments.randomizer->get(0, (std::uint64_t)CombinedTubeCount - 1);
+    return top;
+}
+
+BW_OBJECT_HANDLER(pushRandomDirection) {
+    *++top = (std::uint32_t)arguments.randomizer->get(0, (std::uint64_t)DirectionCount - 1);
+    return top;
+}
+
+BW_OBJECT_HANDLER(pushRandomDoubleDirection) {
+    *++top = (std::uint32_t)arguments.randomizer->get(0, (std::uint64_t)DoubleDirectionCount - 1);
+    return top;
+}
+
+BW_OBJECT_HANDLER(intRandomValue) {
+    *top = (std::uint32_t)arguments.randomizer->get(0, *top);
+    return top;
+}
+
+BW_OBJECT_HANDLER(pushRemembered) {
+    *++top = target.remembered;
+    return top;
+}
+
+BW_OBJECT_HANDLER(pushSnakeAcceleration) {
+    *++top = (std::uint32_t)target.snakeAcceleration;
+    return top;
+}
+
+BW_OBJECT_HANDLER(pushSnakeDirection) {
+    *++top = (std::uint32_t)target.snakeDirection;
+    return top;
+}
+
+BW_OBJECT_HANDLER(pushPreviousSnakeDirection) {
+    *++top = (std::uint32_t)arguments.previousSnakeDirection;
+    return top;
+}
+
+BW_OBJECT_HANDLER(pushParameter) {
+    *++top = arguments.parameter;
+    return top;
+}
+
+BW_OBJECT_HANDLER(logicalNot) {
+    *top = static_cast<std::uint32_t>(!static_cast<bool>(*top));
+    return top;
+}
+
+BW_OBJECT_HANDLER(getOppositeDirection) {
+    *top = (std::uint32_t)oppositeDirection(Direction(*top));
+    return top;
+}
+
+BW_OBJECT_HANDLER(getOppositeAcceleration) {
+    *top = (std::uint32_t)oppositeAcceleration((Acceleration)*top);
+    return top;
+}
+
+BW_OBJECT_HANDLER(logicalOr) {
+    bool reserved = *top;
+    --top;
+    *top = static_cast<std::uint32_t>(reserved || static_cast<bool>(*top));
+    return top;
+}
+
+BW_OBJECT_HANDLER(logicalAnd) {
+    bool reserved = *top;
+    --top;
+    *top = static_cast<std::uint32_t>(reserved && static_cast<bool>(*top));
+    return top;
+}
+
+BW_OBJECT_HANDLER(equal) {
+    std::uint32_t reserved = *top;
+    --top;
+    *top = std::uint32_t(*top == reserved);
+    return top;
+}
+
+BW_OBJECT_HANDLER(select) {
+    bool selectFarther = *top;
+    --top;
+
+    // the farther one is under the nearer one
+    if (!selectFarther)
+        top[-1] = top[0];
+
+    return top - 1;
+}
+
+BW_OBJECT_HANDLER(isDirExitOfDoubleDir) {
+    Direction reserved = (Direction)*top;
+    --top;
+    *top = (std::uint32_t)directionIsExit((DoubleDirection)*top, reserved);
+    return top;
+}
+
+BW_OBJECT_HANDLER(getCombDirExit) {
+    CombinedDirection reserved = (CombinedDirection)*top;
+    --top;
+    *top = (std::uint32_t)getCombinedTubeExit(reserved, (Direction)*top);
+    return top;
+}
+
+BW_OBJECT_HANDLER(intAdd) {
+    std::uint32_t intval = *top;
+    --top;
+    *top += intval;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intSubtract) {
+    std::uint32_t intval = *top;
+    --top;
+    *top -= intval;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intAddOverflow) {
+    std::uint32_t intval = *top;
+    --top;
+    *top = (UINT32_MAX - intval < *top);
+    return top;
+}
+
+BW_OBJECT_HANDLER(intBitAnd) {
+    std::uint32_t intval = *top;
+    --top;
+    *top &= intval;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intBitNot) {
+    *top = ~*top;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intBitOr) {
+    std::uint32_t intval = *top;
+    --top;
+    *top |= intval;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intBitXor) {
+    std::uint32_t intval = *top;
+    --top;
+    *top ^= intval;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intCountOfOnes) {
+    unsigned int howmany = 0;
+    for (std::uint32_t i = 1; i; i <<= 1) {
+        if (*top & i)
+            ++howmany;
+    }
+    *top = howmany;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intCyclicLeftShift) {
+    std::uint32_t intmod = *top;
+    --top;
+    intmod %= 32;
+    std::uint32_t intsrc = *top;
+    *top <<= intmod;
+    intsrc >>= (32 - intmod);
+    *top |= intsrc;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intCyclicRightShift) {
+    std::uint32_t intmod = *top;
+    --top;
+    intmod %= 32;
+    std::uint32_t intsrc = *top;
+    *top >>= intmod;
+    intsrc <<= (32 - intmod);
+    *top |= intsrc;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intDivideAndFloor) {
+    std::uint32_t divisor = *top;
+    --top;
+    if (divisor == 0)
+        *top = 0;
+    else
+        *top /= divisor;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intLess) {
+    std::uint32_t rightVal = *top;
+    --top;
+    *top = (*top < rightVal);
+    return top;
+}
+
+BW_OBJECT_HANDLER(intLogicalLeftShift) {
+    std::uint32_t intval = *top;
+    --top;
+    *top <<= intval;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intLogicalRightShift) {
+    std::uint32_t intval = *top;
+    --top;
+    *top >>= intval;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intMinus) {
+    *top = UINT32_MAX - *top;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intModulo) {
+    std::uint32_t divisor = *top;
+    --top;
+    if (divisor == 0)
+        *top = 0;
+    else
+        *top %= divisor;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intMultiply) {
+    std::uint32_t intval = *top;
+    --top;
+    *top *= intval;
+    return top;
+}
+
+BW_OBJECT_HANDLER(intMultiplyOverflow) {
+    std::uint64_t intval = *top;
+    --top;
+    std::uint64_t product64 = intval * *top;
+    *top = (product64 > UINT32_MAX);
+    return top;
+}
+
+// fused: <value> Int k Equal
+BW_OBJECT_HANDLER(equalOperand) {
+    *top = std::uint32_t(*top == operand);
+    return top;
+}
+
+// fused: <load> <constant> Equal
+BW_OBJECT_HANDLER(snakeAccelerationEqual) {
+    *++top = std::uint32_t((std::uint32_t)target.snakeAcceleration == operand);
+    return top;
+}
+
+BW_OBJECT_HANDLER(rememberedEqual) {
+    *++top = std::uint32_t(target.remembered == operand);
+    return top;
+}
+
+BW_OBJECT_HANDLER(parameterEqual) {
+    *++top = std::uint32_t(arguments.parameter == operand);
+    return top;
+}
+
+// fused: <load> Param* Equal, the usual condition of rotors, tubes and accelerators
+BW_OBJECT_HANDLER(snakeAccelerationEqualParameter) {
+    *++top = std::uint32_t((std::uint32_t)target.snakeAcceleration == arguments.parameter);
+    return top;
+}
+
+BW_OBJECT_HANDLER(snakeDirectionEqualParameter) {
+    *++top = std::uint32_t((std::uint32_t)target.snakeDirection == arguments.parameter);
+    return top;
+}
+
+BW_OBJECT_HANDLER(previousSnakeDirectionEqualParameter) {
+    *++top = std::uint32_t((std::uint32_t)arguments.previousSnakeDirection == arguments.parameter);
+    return top;
+}
+
+#undef BW_OBJECT_HANDLER
+
+
+struct KeywordTraits {
+    Handler handler = nullptr;      // nullptr ends the expression
+    unsigned int popCount = 0;      // every keyword pushes one value
+    bool pure = true;               // depends on nothing but the popped values
+};
+
+
+KeywordTraits getKeywordTraits(ObjectBehaviorKeyword keyword) noexcept {
+    switch (keyword) {
+    case ObjectBehaviorKeyword::AccelerationDefault:     return { pushAccelerationDefault, 0, true };
+    case ObjectBehaviorKeyword::AccelerationDown:        return { pushAccelerationDown, 0, true };
+    case ObjectBehaviorKeyword::AccelerationUp:          return { pushAccelerationUp, 0, true };
+    case ObjectBehaviorKeyword::RandomAcceleration:      return { pushRandomAcceleration, 0, false };
+    case ObjectBehaviorKeyword::RandomCombinedDirection: return { pushRandomCombinedDirection, 0, false };
+    case ObjectBehaviorKeyword::RandomDirection:         return { pushRandomDirection, 0, false };
+    case ObjectBehaviorKeyword::RandomDoubleDirection:   return { pushRandomDoubleDirection, 0, false };
+    case ObjectBehaviorKeyword::IntRandomValue:          return { intRandomValue, 1, false };
+    case ObjectBehaviorKeyword::RememberedInt:           return { pushRemembered, 0, false };
+    case ObjectBehaviorKeyword::SnakeAcceleration:       return { pushSnakeAcceleration, 0, false };
+    case ObjectBehaviorKeyword::SnakeDirection:          return { pushSnakeDirection, 0, false };
+    case ObjectBehaviorKeyword::PreviousSnakeDirection:  return { pushPreviousSnakeDirection, 0, false };
+    case ObjectBehaviorKeyword::ParamAcceleration:
+    case ObjectBehaviorKeyword::ParamDirection:
+    case ObjectBehaviorKeyword::ParamDoubleDirection:
+    case ObjectBehaviorKeyword::ParamCombinedDirection:  return { pushParameter, 0, false };
+    case ObjectBehaviorKeyword::Not:                     return { logicalNot, 1, true };
+    case ObjectBehaviorKeyword::OppositeDirection:       return { getOppositeDirection, 1, true };
+    case ObjectBehaviorKeyword::OppositeAcceleration:    return { getOppositeAcceleration, 1, true };
+    case ObjectBehaviorKeyword::IntMinus:                return { intMinus, 1, true };
+    case ObjectBehaviorKeyword::IntBitNot:               return { intBitNot, 1, true };
+    case ObjectBehaviorKeyword::IntCountOfOnes:          return { intCountOfOnes, 1, true };
+    case ObjectBehaviorKeyword::Or:                      return { logicalOr, 2, true };
+    case ObjectBehaviorKeyword::And:                     return { logicalAnd, 2, true };
+    case ObjectBehaviorKeyword::Equal:                   return { equal, 2, true };
+    case ObjectBehaviorKeyword::IsDirExitOfDoubleDir:    return { isDirExitOfDoubleDir, 2, true };
+    case ObjectBehaviorKeyword::GetCombDirExit:          return { getCombDirExit, 2, true };
+    case ObjectBehaviorKeyword::IntAdd:                  return { intAdd, 2, true };
+    case ObjectBehaviorKeyword::IntSubtract:             return { intSubtract, 2, true };
+    case ObjectBehaviorKeyword::IntMultiply:             return { intMultiply, 2, true };
+    case ObjectBehaviorKeyword::IntDivideAndFloor:       return { intDivideAndFloor, 2, true };
+    case ObjectBehaviorKeyword::IntModulo:               return { intModulo, 2, true };
+    case ObjectBehaviorKeyword::IntLogicalLeftShift:     return { intLogicalLeftShift, 2, true };
+    case ObjectBehaviorKeyword::IntLogicalRightShift:    return { intLogicalRightShift, 2, true };
+    case ObjectBehaviorKeyword::IntCyclicLeftShift:      return { intCyclicLeftShift, 2, true };
+    case ObjectBehaviorKeyword::IntCyclicRightShift:     return { intCyclicRightShift, 2, true };
+    case ObjectBehaviorKeyword::IntBitAnd:               return { intBitAnd, 2, true };
+    case ObjectBehaviorKeyword::IntBitOr:                return { intBitOr, 2, true };
+    case ObjectBehaviorKeyword::IntBitXor:               return { intBitXor, 2, true };
+    case ObjectBehaviorKeyword::IntAddOverflow:          return { intAddOverflow, 2, true };
+    case ObjectBehaviorKeyword::IntMultiplyOverflow:     return { intMultiplyOverflow, 2, true };
+    case ObjectBehaviorKeyword::IntLess:                 return { intLess, 2, true };
+    case ObjectBehaviorKeyword::Select:                  return { select, 3, true };
+    case ObjectBehaviorKeyword::ExpressionEnd:
+    default:                                             return {};
+    }
+}
+
+
+// The fused form of '<load> <constant> Equal', nullptr if there is none
+Handler getFusedEqualConstant(Handler load) noexcept {
+    if (load == pushSnakeAcceleration) return snakeAccelerationEqual;
+    if (load == pushRemembered)        return rememberedEqual;
+    if (load == pushParameter)         return parameterEqual;
+    return nullptr;
+}
+
+
+// The fused form of '<load> Param* Equal', nullptr if there is none
+Handler getFusedEqualParameter(Handler load) noexcept {
+    if (load == pushSnakeAcceleration)      return snakeAccelerationEqualParameter;
+    if (load == pushSnakeDirection)         return snakeDirectionEqualParameter;
+    if (load == pushPreviousSnakeDirection) return previousSnakeDirectionEqualParameter;
+    return nullptr;
+}
+
+}
+
 namespace Bulletworm {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -37,7 +445,14 @@ ObjectBehavior::ObjectBehavior() noexcept :
     m_conditionExpressions(),
     m_modifyExpressions(),
     m_commands(),
+    m_code(),
+    m_conditionPrograms(),
+    m_modifyPrograms(),
+    m_memo(),
+    m_memoDomains(),
+    m_memoStrides(),
     m_properties(),
+    m_stackDepth(0),
     m_parameterType(ObjectParameterType::NoParameter)
 {}
 
@@ -47,9 +462,17 @@ ObjectBehavior::ObjectBehavior(ObjectBehavior&& src) noexcept :
     m_conditionExpressions(std::move(src.m_conditionExpressions)),
     m_modifyExpressions(std::move(src.m_modifyExpressions)),
     m_commands(std::move(src.m_commands)),
+    m_code(std::move(src.m_code)),
+    m_conditionPrograms(std::move(src.m_conditionPrograms)),
+    m_modifyPrograms(std::move(src.m_modifyPrograms)),
+    m_memo(std::move(src.m_memo)),
+    m_memoDomains(src.m_memoDomains),
+    m_memoStrides(src.m_memoStrides),
     m_properties(std::move(src.m_properties)),
+    m_stackDepth(src.m_stackDepth),
     m_parameterType(src.m_parameterType) {
     src.m_properties.reset();
+    src.m_stackDepth = 0;
     src.m_parameterType = ObjectParameterType::NoParameter;
 }
 
@@ -60,13 +483,21 @@ ObjectBehavior& ObjectBehavior::operator=(ObjectBehavior&& src) noexcept {
         return *this;
 
     m_commands = std::move(src.m_commands);
+    m_code = std::move(src.m_code);
+    m_conditionPrograms = std::move(src.m_conditionPrograms);
+    m_modifyPrograms = std::move(src.m_modifyPrograms);
+    m_memo = std::move(src.m_memo);
+    m_memoDomains = src.m_memoDomains;
+    m_memoStrides = src.m_memoStrides;
     m_conditionExpressions = std::move(src.m_conditionExpressions);
     m_modifyExpressions = std::move(src.m_modifyExpressions);
     m_parameterType = src.m_parameterType;
     m_properties = std::move(src.m_properties);
+    m_stackDepth = src.m_stackDepth;
 
     src.m_parameterType = ObjectParameterType::NoParameter;
     src.m_properties.reset();
+    src.m_stackDepth = 0;
 
     return *this;
 }
@@ -132,6 +563,7 @@ std::optional<std::string> ObjectBehavior::compile(const CompileParameters& para
     m_properties[(std::size_t)ObjectProperty::IsDangerous] = dangerous;
     m_properties[(std::size_t)ObjectProperty::RequiresRandom] = states.requiresRandom;
     m_parameterType = states.paramType;
+    m_stackDepth = states.stackDepth;
 
     m_commands.assign(parameters.commands, parameters.commands + parameters.conditionCount + 1);
     m_conditionExpressions.resize(parameters.conditionCount);
@@ -152,6 +584,25 @@ std::optional<std::string> ObjectBehavior::compile(const CompileParameters& para
         }
     }
 
+    // Only the validated expressions are lowered
+    m_code.clear();
+    m_conditionPrograms.resize(parameters.conditionCount);
+    m_modifyPrograms.assign(parameters.conditionCount + 1, Program());
+
+    for (std::size_t i = 0; i < parameters.conditionCount; ++i)
+        m_conditionPrograms[i] = lowerValueExpression(parameters.condExpressions[i],
+                                                      parameters.condExpressionSizes[i], m_code);
+
+    for (std::size_t i = 0; i < parameters.conditionCount + 1; ++i) {
+        if (parameters.commands[i] == ObjectCommand::ModifyAcceleration ||
+            parameters.commands[i] == ObjectCommand::ModifyDirection ||
+            parameters.commands[i] == ObjectCommand::Remember)
+            m_modifyPrograms[i] = lowerValueExpression(parameters.modifyExpressions[i],
+                                                       parameters.modifyExpressionSizes[i], m_code);
+    }
+
+    buildMemo(states);
+
     return {};
 }
 
@@ -161,12 +612,27 @@ void ObjectBehavior::activate(ExecutionTarget& target, const ExecutionArguments&
     if (m_commands.empty())
         return;
 
-    std::size_t commandIndex = 0;
-    while (commandIndex < m_conditionExpressions.size()) {
-        const auto& currentExpression = m_conditionExpressions[commandIndex];
+    std::size_t memoIndex = 0;
+    if (!m_memo.empty() && getMemoIndex(target, arguments, memoIndex)) {
+        applyOutcome(m_memo[memoIndex], target);
+        return;
+    }
+
+    // The depth is known since compile(), so the usual programs
+    // run on the thread stack and never touch the heap
+    std::array<std::uint32_t, InlineStackDepth + 1> inlineStack;
+    std::vector<std::uint32_t> heapStack;
+    std::uint32_t* stack = inlineStack.data();
 
-        if (computeValueExpression(currentExpression.data(),
-            currentExpression.size(), target, arguments))
+    if (m_stackDepth > InlineStackDepth) {
+        heapStack.resize(m_stackDepth + 1);
+        stack = heapStack.data();
+    }
+
+    // applyOutcome(evaluate()) spelled out: the calls cost the short programs ~15%
+    std::size_t commandIndex = 0;
+    while (commandIndex < m_conditionPrograms.size()) {
+        if (execute(m_conditionPrograms[commandIndex], target, arguments, stack))
             break;
 
         ++commandIndex;
@@ -176,7 +642,7 @@ void ObjectBehavior::activate(ExecutionTarget& target, const ExecutionArguments&
     if (commandIndex >= m_commands.size())
         return;
 
-    const auto& activeModifyExpression = m_modifyExpressions[commandIndex];
+    const Program& activeModifyProgram = m_modifyPrograms[commandIndex];
 
     switch (m_commands[commandIndex]) {
     case ObjectCommand::KillSnake:
@@ -187,17 +653,14 @@ void ObjectBehavior::activate(ExecutionTarget& target, const ExecutionArguments&
         break;
     case ObjectCommand::ModifyAcceleration:
         target.snakeAcceleration =
-            (Acceleration)computeValueExpression(activeModifyExpression.data(),
-                                      activeModifyExpression.size(), target, arguments);
+            (Acceleration)execute(activeModifyProgram, target, arguments, stack);
         break;
     case ObjectCommand::ModifyDirection:
         target.snakeDirection =
-            (Direction)computeValueExpression(activeModifyExpression.data(),
-                                   activeModifyExpression.size(), target, arguments);
+            (Direction)execute(activeModifyProgram, target, arguments, stack);
         break;
     case ObjectCommand::Remember:
-        target.remembered = computeValueExpression(activeModifyExpression.data(),
-                                                   activeModifyExpression.size(), target, arguments);
+        target.remembered = execute(activeModifyProgram, target, arguments, stack);
         break;
     default:
         break;
@@ -206,281 +669,289 @@ void ObjectBehavior::activate(ExecutionTarget& target, const ExecutionArguments&
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-std::uint32_t ObjectBehavior::computeValueExpression(
-    const std::uint32_t* expression,
-    std::size_t keywordCount,
-    const ExecutionTarget& target,
-    const ExecutionArguments& arguments) {
-    std::forward_list<std::uint32_t> stack;
-    std::size_t pointer = 0;
+ObjectBehavior::Outcome ObjectBehavior::evaluate(const ExecutionTarget& target,
+                                                 const ExecutionArguments& arguments,
+                                                 std::uint32_t* stack) const {
+    std::size_t commandIndex = 0;
+    while (commandIndex < m_conditionPrograms.size()) {
+        if (execute(m_conditionPrograms[commandIndex], target, arguments, stack))
+            break;
 
-    bool isInteger = false;
+        ++commandIndex;
+    }
 
-    bool again = true;
-    while (again) {
-        if (pointer >= keywordCount)
-            break;
+    // If without else
+    if (commandIndex >= m_commands.size())
+        return {};
 
-        if (isInteger) {
-            stack.push_front(expression[pointer]);
-            isInteger = false;
-        } else {
-            switch ((ObjectBehaviorKeyword)expression[pointer]) {
-            case ObjectBehaviorKeyword::AccelerationDefault:
-                stack.push_front((std::uint32_t)Acceleration::Default);
-                break;
-            case ObjectBehaviorKeyword::AccelerationDown:
-                stack.push_front((std::uint32_t)Acceleration::Down);
-                break;
-            case ObjectBehaviorKeyword::AccelerationUp:
-                stack.push_front((std::uint32_t)Acceleration::Up);
-                break;
-            case ObjectBehaviorKeyword::RandomAcceleration:
-                stack.push_front((std::uint32_t)arguments.randomizer->get(0, 
-                                 (std::uint64_t)AccelerationCount - 1));
-                break;
-            case ObjectBehaviorKeyword::RandomCombinedDirection:
-                stack.push_front((std::uint32_t)arguments.randomizer->get(0, 
-                                 (std::uint64_t)CombinedTubeCount - 1));
-                break;
-            case ObjectBehaviorKeyword::RandomDirection:
-                stack.push_front((std::uint32_t)arguments.randomizer->get(0, 
-                                 (std::uint64_t)DirectionCount - 1));
-                break;
-            case ObjectBehaviorKeyword::RandomDoubleDirection:
-                stack.push_front((std::uint32_t)arguments.randomizer->get(0, 
-                                 (std::uint64_t)DoubleDirectionCount - 1));
-                break;
-            case ObjectBehaviorKeyword::IntRandomValue:
-                stack.front() = (std::uint32_t)arguments.randomizer->get(0,
-                                                                         stack.front());
-                break;
-            case ObjectBehaviorKeyword::RememberedInt:
-                stack.push_front(target.remembered);
-                break;
-            case ObjectBehaviorKeyword::Not:
-                stack.front() = static_cast<std::uint32_t>(!static_cast<bool>(stack.front()));
-                break;
-            case ObjectBehaviorKeyword::OppositeDirection:
-                stack.front() = (std::uint32_t)oppositeDirection(Direction(stack.front()));
-                break;
-            case ObjectBehaviorKeyword::OppositeAcceleration:
-                stack.front() = (std::uint32_t)oppositeAcceleration((Acceleration)stack.front());
-                break;
-            case ObjectBehaviorKeyword::Or:
-            {
-                bool reserved = stack.front();
-                stack.pop_front();
-                stack.front() =
-                    static_cast<std::uint32_t>(reserved || static_cast<bool>(stack.front()));
-                break;
-            }
-            case ObjectBehaviorKeyword::And:
-            {
-                bool reserved = stack.front();
-                stack.pop_front();
-                stack.front() =
-                    static_cast<std::uint32_t>(reserved && static_cast<bool>(stack.front()));
-                break;
-            }
-            case ObjectBehaviorKeyword::Equal:
-            {
-                std::uint32_t reserved = stack.front();
-                stack.pop_front();
-                stack.front() = std::uint32_t(stack.front() == reserved);
-                break;
-            }
-            case ObjectBehaviorKeyword::Select:
-            {
-                bool selectFarther = stack.front();
-                stack.pop_front();
+    Outcome outcome;
+    outcome.command = m_commands[commandIndex];
 
-                if (selectFarther)
-                    stack.pop_front();
-                else
-                    stack.erase_after(stack.begin());
+    switch (outcome.command) {
+    case ObjectCommand::ModifyAcceleration:
+    case ObjectCommand::ModifyDirection:
+    case ObjectCommand::Remember:
+        outcome.value = execute(m_modifyPrograms[commandIndex], target, arguments, stack);
+        break;
+    default:
+        break;
+    }
 
+    return outcome;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void ObjectBehavior::applyOutcome(const Outcome& outcome, ExecutionTarget& target) noexcept {
+    switch (outcome.command) {
+    case ObjectCommand::KillSnake:
+        target.alive = false;
+        break;
+    case ObjectCommand::StopSnake:
+        target.moving = false;
+        break;
+    case ObjectCommand::ModifyAcceleration:
+        target.snakeAcceleration = (Acceleration)outcome.value;
+        break;
+    case ObjectCommand::ModifyDirection:
+        target.snakeDirection = (Direction)outcome.value;
+        break;
+    case ObjectCommand::Remember:
+        target.remembered = outcome.value;
+        break;
+    default:
+        break;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+bool ObjectBehavior::getMemoIndex(const ExecutionTarget& target,
+                                  const ExecutionArguments& arguments,
+                                  std::size_t& index) const noexcept {
+    const std::array<std::uint32_t, MemoInputCount> values{
+        arguments.parameter,
+        (std::uint32_t)arguments.previousSnakeDirection,
+        (std::uint32_t)target.snakeDirection,
+        (std::uint32_t)target.snakeAcceleration
+    };
+
+    index = 0;
+    for (std::size_t i = 0; i < MemoInputCount; ++i) {
+        // an unread input has the domain of 0, so it never takes part
+        if (!m_memoDomains[i])
+            continue;
+
+        // e.g. the undefined previous direction: interpret
+        if (values[i] >= m_memoDomains[i])
+            return false;
+
+        index += values[i] * m_memoStrides[i];
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void ObjectBehavior::buildMemo(const EffectAttributeStates& states) {
+    m_memo.clear();
+    m_memoDomains.fill(0);
+    m_memoStrides.fill(0);
+
+    if (m_commands.empty() || states.requiresRandom ||
+        states.inputs[(std::size_t)ExecutionInput::Remembered])
+        return;
+
+    std::uint32_t parameterDomain = 0;
+    switch (m_parameterType) {
+    case ObjectParameterType::Acceleration:
+        parameterDomain = AccelerationCount;
+        break;
+    case ObjectParameterType::Direction:
+        parameterDomain = DirectionCount;
+        break;
+    case ObjectParameterType::DoubleDirection:
+        parameterDomain = DoubleDirectionCount;
+        break;
+    case ObjectParameterType::CombinedDirection:
+        parameterDomain = CombinedTubeCount;
+        break;
+    default:
+        break;
+    }
+
+    m_memoDomains = {
+        parameterDomain,
+        states.inputs[(std::size_t)ExecutionInput::PreviousSnakeDirection] ? (std::uint32_t)DirectionCount : 0u,
+        states.inputs[(std::size_t)ExecutionInput::SnakeDirection] ? (std::uint32_t)DirectionCount : 0u,
+        states.inputs[(std::size_t)ExecutionInput::SnakeAcceleration] ? (std::uint32_t)AccelerationCount : 0u
+    };
+
+    std::size_t memoSize = 1;
+    for (std::size_t i = 0; i < MemoInputCount; ++i) {
+        if (m_memoDomains[i]) {
+            m_memoStrides[i] = (std::uint32_t)memoSize;
+            memoSize *= m_memoDomains[i];
+        }
+    }
+
+    if (memoSize > MemoSizeLimit) {
+        m_memoDomains.fill(0);
+        m_memoStrides.fill(0);
+        return;
+    }
+
+    std::vector<std::uint32_t> stack(m_stackDepth + 1);
+    m_memo.resize(memoSize);
+
+    for (std::size_t index = 0; index < memoSize; ++index) {
+        std::array<std::uint32_t, MemoInputCount> values{};
+        for (std::size_t i = 0; i < MemoInputCount; ++i) {
+            if (m_memoDomains[i])
+                values[i] = (std::uint32_t)(index / m_memoStrides[i] % m_memoDomains[i]);
+        }
+
+        ExecutionArguments arguments;
+        arguments.parameter = values[0];
+        arguments.previousSnakeDirection = (Direction)values[1];
+
+        // the outcome reads neither alive, moving nor remembered
+        ExecutionTarget target{};
+        target.snakeDirection = (Direction)values[2];
+        target.snakeAcceleration = (Acceleration)values[3];
+
+        m_memo[index] = evaluate(target, arguments, stack.data());
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+ObjectBehavior::Program ObjectBehavior::lowerValueExpression(const std::uint32_t* expression,
+                                                             std::size_t keywordCount,
+                                                             std::vector<Instruction>& code) {
+    // The value stack as known at compile time
+    struct Value {
+        bool constant;
+        std::uint32_t value;
+    };
+
+    // Pure handlers read neither of them
+    static const ExecutionTarget foldTarget{};
+    static const ExecutionArguments foldArguments{};
+
+    std::vector<Value> stack;
+    Program program;
+    program.begin = (std::uint32_t)code.size();
+
+    for (std::size_t pointer = 0; pointer < keywordCount; ++pointer) {
+        ObjectBehaviorKeyword keyword = (ObjectBehaviorKeyword)expression[pointer];
+
+        if (keyword == ObjectBehaviorKeyword::Int) {
+            if (++pointer >= keywordCount)
                 break;
-            }
-            case ObjectBehaviorKeyword::IsDirExitOfDoubleDir:
-            {
-                Direction reserved = (Direction)stack.front();
-                stack.pop_front();
-                stack.front() = (std::uint32_t)directionIsExit((DoubleDirection)stack.front(), reserved);
-                break;
-            }
-            case ObjectBehaviorKeyword::GetCombDirExit:
-            {
-                CombinedDirection reserved = (CombinedDirection)stack.front();
-                stack.pop_front();
-                stack.front() = (std::uint32_t)getCombinedTubeExit(reserved, (Direction)stack.front());
-                break;
-            }
-            case ObjectBehaviorKeyword::SnakeAcceleration:
-                stack.push_front((std::uint32_t)target.snakeAcceleration);
-                break;
-            case ObjectBehaviorKeyword::SnakeDirection:
-                stack.push_front((std::uint32_t)target.snakeDirection);
-                break;
-            case ObjectBehaviorKeyword::PreviousSnakeDirection:
-                stack.push_front((std::uint32_t)arguments.previousSnakeDirection);
-                break;
-            case ObjectBehaviorKeyword::ParamAcceleration:
-            case ObjectBehaviorKeyword::ParamDirection:
-            case ObjectBehaviorKeyword::ParamDoubleDirection:
-            case ObjectBehaviorKeyword::ParamCombinedDirection:
-                stack.push_front(arguments.parameter);
-                break;
-            case ObjectBehaviorKeyword::Int:
-                isInteger = true;
-                break;
-            case ObjectBehaviorKeyword::IntAdd:
-            {
-                std::uint32_t intval = stack.front();
-                stack.pop_front();
-                stack.front() += intval;
-                break;
-            }
-            case ObjectBehaviorKeyword::IntSubtract:
-            {
-                std::uint32_t intval = stack.front();
-                stack.pop_front();
-                stack.front() -= intval;
-                break;
-            }
-            case ObjectBehaviorKeyword::IntAddOverflow:
-            {
-                std::uint32_t intval = stack.front();
-                stack.pop_front();
-                stack.front() = (UINT32_MAX - intval < stack.front());
-                break;
-            }
-            case ObjectBehaviorKeyword::IntBitAnd:
-            {
-                std::uint32_t intval = stack.front();
-                stack.pop_front();
-                stack.front() &= intval;
-                break;
-            }
-            case ObjectBehaviorKeyword::IntBitNot:
-                stack.front() = ~stack.front();
-                break;
-            case ObjectBehaviorKeyword::IntBitOr:
-            {
-                std::uint32_t intval = stack.front();
-                stack.pop_front();
-                stack.front() |= intval;
-                break;
-            }
-            case ObjectBehaviorKeyword::IntBitXor:
-            {
-                std::uint32_t intval = stack.front();
-                stack.pop_front();
-                stack.front() ^= intval;
-                break;
-            }
-            case ObjectBehaviorKeyword::IntCountOfOnes:
-            {
-                unsigned int howmany = 0;
-                for (std::uint32_t i = 1; i; i <<= 1) {
-                    if (stack.front() & i)
-                        ++howmany;
+
+            code.push_back({ pushOperand, expression[pointer] });
+            stack.push_back({ true, expression[pointer] });
+            continue;
+        }
+
+        KeywordTraits traits = getKeywordTraits(keyword);
+        if (!traits.handler)
+            break;
+
+        assert(stack.size() >= traits.popCount);
+        Value* operands = stack.data() + stack.size() - traits.popCount;
+
+        bool constant = traits.pure;
+        for (unsigned int i = 0; i < traits.popCount; ++i)
+            constant = constant && operands[i].constant;
+
+        if (constant) {
+            // Every constant value is a single pushOperand, so the operands
+            // are the last instructions: evaluate them now and push the result instead
+            std::array<std::uint32_t, 4> values{};
+            for (unsigned int i = 0; i < traits.popCount; ++i)
+                values[i + 1] = operands[i].value;
+
+            std::uint32_t result = *traits.handler(values.data() + traits.popCount, 0,
+                                                   foldTarget, foldArguments);
+
+            code.resize(code.size() - traits.popCount);
+            stack.resize(stack.size() - traits.popCount);
+            code.push_back({ pushOperand, result });
+            stack.push_back({ true, result });
+            continue;
+        }
+
+        if (keyword == ObjectBehaviorKeyword::Equal) {
+            // Every load is a single instruction as well
+            Handler fused = nullptr;
+            std::uint32_t operand = 0;
+            std::size_t fusedCount = 0;
+
+            if (operands[1].constant) {
+                // [.. left, pushOperand]
+                Handler left = code[code.size() - 2].handler;
+                fused = getFusedEqualConstant(left);
+                operand = operands[1].value;
+                fusedCount = 2;
+
+                if (!fused) {
+                    fused = equalOperand;
+                    fusedCount = 1;
                 }
-                stack.front() = howmany;
-                break;
-            }
-            case ObjectBehaviorKeyword::IntCyclicLeftShift:
-            {
-                std::uint32_t intmod = stack.front();
-                stack.pop_front();
-                intmod %= 32;
-                std::uint32_t intsrc = stack.front();
-                stack.front() <<= intmod;
-                intsrc >>= (32 - intmod);
-                stack.front() |= intsrc;
-                break;
-            }
-            case ObjectBehaviorKeyword::IntCyclicRightShift:
-            {
-                std::uint32_t intmod = stack.front();
-                stack.pop_front();
-                intmod %= 32;
-                std::uint32_t intsrc = stack.front();
-                stack.front() >>= intmod;
-                intsrc <<= (32 - intmod);
-                stack.front() |= intsrc;
-                break;
-            }
-            case ObjectBehaviorKeyword::IntDivideAndFloor:
-            {
-                std::uint32_t divisor = stack.front();
-                stack.pop_front();
-                if (divisor == 0)
-                    stack.front() = 0;
-                else
-                    stack.front() /= divisor;
-                break;
-            }
-            case ObjectBehaviorKeyword::IntLess:
-            {
-                std::uint32_t rightVal = stack.front();
-                stack.pop_front();
-                stack.front() = (stack.front() < rightVal);
-                break;
-            }
-            case ObjectBehaviorKeyword::IntLogicalLeftShift:
-            {
-                std::uint32_t intval = stack.front();
-                stack.pop_front();
-                stack.front() <<= intval;
-                break;
-            }
-            case ObjectBehaviorKeyword::IntLogicalRightShift:
-            {
-                std::uint32_t intval = stack.front();
-                stack.pop_front();
-                stack.front() >>= intval;
-                break;
-            }
-            case ObjectBehaviorKeyword::IntMinus:
-                stack.front() = UINT32_MAX - stack.front();
-                break;
-            case ObjectBehaviorKeyword::IntModulo:
-            {
-                std::uint32_t divisor = stack.front();
-                stack.pop_front();
-                if (divisor == 0)
-                    stack.front() = 0;
-                else
-                    stack.front() %= divisor;
-                break;
+            } else if (operands[0].constant) {
+                // [.. pushOperand, right]
+                fused = getFusedEqualConstant(code.back().handler);
+                operand = operands[0].value;
+                fusedCount = 2;
+            } else if (code.size() - program.begin >= 2) {
+                // [.. left, right]
+                Handler left = code[code.size() - 2].handler;
+                Handler right = code.back().handler;
+
+                if (right == pushParameter)
+                    fused = getFusedEqualParameter(left);
+                else if (left == pushParameter)
+                    fused = getFusedEqualParameter(right);
+
+                fusedCount = 2;
             }
-            case ObjectBehaviorKeyword::IntMultiply:
-            {
-                std::uint32_t intval = stack.front();
-                stack.pop_front();
-                stack.front() *= intval;
-                break;
-            }
-            case ObjectBehaviorKeyword::IntMultiplyOverflow:
-            {
-                std::uint64_t intval = stack.front();
-                stack.pop_front();
-                std::uint64_t product64 = intval * stack.front();
-                stack.front() = (product64 > UINT32_MAX);
-                break;
-            }
-            case ObjectBehaviorKeyword::ExpressionEnd:
-            default:
-                again = false;
-                break;
+
+            if (fused) {
+                code.resize(code.size() - fusedCount);
+                code.push_back({ fused, operand });
+                stack.pop_back();
+                stack.back().constant = false;
+                continue;
             }
         }
 
-        ++pointer;
+        code.push_back({ traits.handler, 0 });
+        stack.resize(stack.size() - traits.popCount);
+        stack.push_back({ false, 0 });
     }
 
-    return stack.front();
+    program.end = (std::uint32_t)code.size();
+    return program;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+std::uint32_t ObjectBehavior::execute(const Program& program,
+                                      const ExecutionTarget& target,
+                                      const ExecutionArguments& arguments,
+                                      std::uint32_t* stack) const {
+    // stack[0] is never written, the first value goes to stack[1]
+    std::uint32_t* top = stack;
+
+    const Instruction* end = m_code.data() + program.end;
+    for (const Instruction* instruction = m_code.data() + program.begin;
+         instruction != end; ++instruction)
+        top = instruction->handler(top, instruction->operand, target, arguments);
+
+    return *top;
 }
 
 
@@ -491,7 +962,7 @@ std::optional<std::string> ObjectBehavior::validateValueExpression(StackValueTyp
                                                                     EffectAttributeStates& states) {
     assert(expression && keywordCount);
 
-    std::forward_list<StackValueType> stack;
+    std::vector<StackValueType> stack;
     std::size_t pointer = 0;
 
     bool isInteger = false;
@@ -502,57 +973,57 @@ std::optional<std::string> ObjectBehavior::validateValueExpression(StackValueTyp
             break;
 
         if (isInteger) {
-            stack.push_front(StackValueType::Integer);
+            stack.push_back(StackValueType::Integer);
             isInteger = false;
         } else {
             switch ((ObjectBehaviorKeyword)expression[pointer]) {
             case ObjectBehaviorKeyword::AccelerationDown:
             case ObjectBehaviorKeyword::AccelerationDefault:
             case ObjectBehaviorKeyword::AccelerationUp:
-                stack.push_front(StackValueType::Acceleration);
+                stack.push_back(StackValueType::Acceleration);
                 break;
 
             case ObjectBehaviorKeyword::RandomAcceleration:
-                stack.push_front(StackValueType::Acceleration);
+                stack.push_back(StackValueType::Acceleration);
                 states.requiresRandom = true;
                 break;
 
             case ObjectBehaviorKeyword::IntRandomValue:
 
-                if (stack.empty() || stack.front() != StackValueType::Integer)
+                if (stack.empty() || stack.back() != StackValueType::Integer)
                     return "TODO";
 
                 states.requiresRandom = true;
                 break;
 
             case ObjectBehaviorKeyword::RandomCombinedDirection:
-                stack.push_front(StackValueType::CombinedDirection);
+                stack.push_back(StackValueType::CombinedDirection);
                 states.requiresRandom = true;
                 break;
 
             case ObjectBehaviorKeyword::RandomDirection:
-                stack.push_front(StackValueType::Direction);
+                stack.push_back(StackValueType::Direction);
                 states.requiresRandom = true;
                 break;
 
             case ObjectBehaviorKeyword::RandomDoubleDirection:
-                stack.push_front(StackValueType::DoubleDirection);
+                stack.push_back(StackValueType::DoubleDirection);
                 states.requiresRandom = true;
                 break;
 
             case ObjectBehaviorKeyword::RememberedInt:
-
-                stack.push_front(StackValueType::Integer);
+                states.inputs[(std::size_t)ExecutionInput::Remembered] = true;
+                stack.push_back(StackValueType::Integer);
                 break;
 
             case ObjectBehaviorKeyword::OppositeDirection:
-                if (stack.empty() || stack.front() != StackValueType::Direction)
+                if (stack.empty() || stack.back() != StackValueType::Direction)
                     return "Lack of value in the stack (Direction)";
 
                 break;
 
             case ObjectBehaviorKeyword::OppositeAcceleration:
-                if (stack.empty() || stack.front() != StackValueType::Acceleration)
+                if (stack.empty() || stack.back() != StackValueType::Acceleration)
                     return "Lack of value in the stack (Acceleration)";
 
                 break;
@@ -574,17 +1045,17 @@ std::optional<std::string> ObjectBehavior::validateValueExpression(StackValueTyp
             case ObjectBehaviorKeyword::IntMultiplyOverflow:
             case ObjectBehaviorKeyword::IntSubtract:
             case ObjectBehaviorKeyword::IntLess:
-                if (stack.empty() || stack.front() != StackValueType::Integer)
+                if (stack.empty() || stack.back() != StackValueType::Integer)
                     return "Lack of value in the stack (Int)";
 
-                stack.pop_front();
+                stack.pop_back();
                 [[fallthrough]];
 
             case ObjectBehaviorKeyword::Not:
             case ObjectBehaviorKeyword::IntBitNot:
             case ObjectBehaviorKeyword::IntCountOfOnes:
             case ObjectBehaviorKeyword::IntMinus:
-                if (stack.empty() || stack.front() != StackValueType::Integer)
+                if (stack.empty() || stack.back() != StackValueType::Integer)
                     return "Lack of value in the stack (Int)";
 
                 break;
@@ -594,73 +1065,79 @@ std::optional<std::string> ObjectBehavior::validateValueExpression(StackValueTyp
                 if (stack.empty())
                     return "Lack of value in the stack (empty)";
 
-                StackValueType currentType = stack.front();
-                stack.pop_front();
+                StackValueType currentType = stack.back();
+                stack.pop_back();
 
-                if (stack.empty() || currentType != stack.front())
+                if (stack.empty() || currentType != stack.back())
                     return "Lack of value in the stack: wrong type";
 
                 if (currentType != StackValueType::Integer) {
-                    stack.pop_front();
-                    stack.push_front(StackValueType::Integer);
+                    stack.pop_back();
+                    stack.push_back(StackValueType::Integer);
                 }
 
                 break;
             }
             case ObjectBehaviorKeyword::Select:
             {
-                if (stack.empty() || stack.front() != StackValueType::Integer)
+                if (stack.empty() || stack.back() != StackValueType::Integer)
                     return "Lack of value in the stack (Boolean)";
 
-                stack.pop_front();
+                stack.pop_back();
 
                 if (stack.empty())
                     return "Lack of value in the stack (empty)";
 
-                StackValueType currentType = stack.front();
-                stack.pop_front();
+                StackValueType currentType = stack.back();
+                stack.pop_back();
 
-                if (stack.empty() || currentType != stack.front())
+                if (stack.empty() || currentType != stack.back())
                     return "Lack of value in the stack: wrong type";
 
                 if (currentType != StackValueType::Integer) {
-                    stack.pop_front();
-                    stack.push_front(currentType);
+                    stack.pop_back();
+                    stack.push_back(currentType);
                 }
 
                 break;
             }
             case ObjectBehaviorKeyword::IsDirExitOfDoubleDir:
-                if (stack.empty() || stack.front() != StackValueType::Direction)
+                if (stack.empty() || stack.back() != StackValueType::Direction)
                     return "Lack of value in the stack (direction)";
 
-                stack.pop_front();
+                stack.pop_back();
 
-                if (stack.empty() || stack.front() != StackValueType::DoubleDirection)
+                if (stack.empty() || stack.back() != StackValueType::DoubleDirection)
                     return "Lack of value in the stack (DoubleDirection)";
 
-                stack.pop_front();
-                stack.push_front(StackValueType::Integer);
+                stack.pop_back();
+                stack.push_back(StackValueType::Integer);
                 break;
 
             case ObjectBehaviorKeyword::GetCombDirExit:
-                if (stack.empty() || stack.front() != StackValueType::CombinedDirection)
+                if (stack.empty() || stack.back() != StackValueType::CombinedDirection)
                     return "Lack of value in the stack (CombinedDirection)";
 
-                stack.pop_front();
+                stack.pop_back();
 
-                if (stack.empty() || stack.front() != StackValueType::Direction)
+                if (stack.empty() || stack.back() != StackValueType::Direction)
                     return "Lack of value in the stack (direction)";
 
                 break;
 
             case ObjectBehaviorKeyword::SnakeAcceleration:
-                stack.push_front(StackValueType::Acceleration);
+                states.inputs[(std::size_t)ExecutionInput::SnakeAcceleration] = true;
+                stack.push_back(StackValueType::Acceleration);
                 break;
 
             case ObjectBehaviorKeyword::SnakeDirection:
+                states.inputs[(std::size_t)ExecutionInput::SnakeDirection] = true;
+                stack.push_back(StackValueType::Direction);
+                break;
+
             case ObjectBehaviorKeyword::PreviousSnakeDirection:
-                stack.push_front(StackValueType::Direction);
+                states.inputs[(std::size_t)ExecutionInput::PreviousSnakeDirection] = true;
+                stack.push_back(StackValueType::Direction);
                 break;
 
             case ObjectBehaviorKeyword::ParamAcceleration:
@@ -670,7 +1147,7 @@ std::optional<std::string> ObjectBehavior::validateValueExpression(StackValueTyp
                     return "Parameter corruption (acceleration)";
 
                 states.paramType = ObjectParameterType::Acceleration;
-                stack.push_front(StackValueType::Acceleration);
+                stack.push_back(StackValueType::Acceleration);
                 break;
 
             case ObjectBehaviorKeyword::ParamDirection:
@@ -680,7 +1157,7 @@ std::optional<std::string> ObjectBehavior::validateValueExpression(StackValueTyp
                     return "Parameter corruption (direction)";
 
                 states.paramType = ObjectParameterType::Direction;
-                stack.push_front(StackValueType::Direction);
+                stack.push_back(StackValueType::Direction);
                 break;
 
             case ObjectBehaviorKeyword::ParamDoubleDirection:
@@ -690,7 +1167,7 @@ std::optional<std::string> ObjectBehavior::validateValueExpression(StackValueTyp
                     return "Parameter corruption (double direction)";
 
                 states.paramType = ObjectParameterType::DoubleDirection;
-                stack.push_front(StackValueType::DoubleDirection);
+                stack.push_back(StackValueType::DoubleDirection);
                 break;
 
             case ObjectBehaviorKeyword::ParamCombinedDirection:
@@ -700,7 +1177,7 @@ std::optional<std::string> ObjectBehavior::validateValueExpression(StackValueTyp
                     return "Parameter corruption (combined direction)";
 
                 states.paramType = ObjectParameterType::CombinedDirection;
-                stack.push_front(StackValueType::CombinedDirection);
+                stack.push_back(StackValueType::CombinedDirection);
                 break;
 
             case ObjectBehaviorKeyword::Int:
@@ -712,10 +1189,12 @@ std::optional<std::string> ObjectBehavior::validateValueExpression(StackValueTyp
                 break;
             }
         }
+
+        states.stackDepth = std::max(states.stackDepth, stack.size());
         ++pointer;
     }
 
-    if (stack.empty() || (stack.front() != type))
+    if (stack.empty() || (stack.back() != type))
         return "Expression is invalid: stack is empty or returns wrong type";
 
     return {};
@@ -730,4 +1209,54 @@ bool ObjectBehavior::getProperty(ObjectProperty prop) const noexcept {
     return m_properties[(std::size_t)prop];
 }
 
+
+std::size_t ObjectBehavior::getStackDepth() const noexcept {
+    return m_stackDepth;
+}
+
+
+bool ObjectBehavior::isInert() const noexcept {
+    if (m_commands.empty())
+        return true;
+
+    if (m_properties[(std::size_t)ObjectProperty::RequiresRandom])
+        return false;
+
+    return std::all_of(m_commands.begin(), m_commands.end(),
+                       [](ObjectCommand command) { return command == ObjectCommand::NoCommand; });
+}
+
+
+bool ObjectBehavior::isMemoized() const noexcept {
+    return !m_memo.empty();
+}
+
+
+std::size_t ObjectBehavior::getCommandCount() const noexcept {
+    return m_commands.size();
+}
+
+
+std::size_t ObjectBehavior::getConditionCount() const noexcept {
+    return m_conditionExpressions.size();
+}
+
+
+const std::vector<std::uint32_t>& ObjectBehavior::getConditionExpression(std::size_t index) const noexcept {
+    assert(index < m_conditionExpressions.size());
+    return m_conditionExpressions[index];
+}
+
+
+const std::vector<std::uint32_t>& ObjectBehavior::getModifyExpression(std::size_t index) const noexcept {
+    assert(index < m_modifyExpressions.size());
+    return m_modifyExpressions[index];
+}
+
+
+ObjectCommand ObjectBehavior::getCommand(std::size_t index) const noexcept {
+    assert(index < m_commands.size());
+    return m_commands[index];
+}
+
 } // namespace Bulletworm
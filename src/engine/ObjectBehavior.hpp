@@ -29,6 +29,7 @@
 #include <vector>
 #include <optional>
 #include <bitset>
+#include <array>
 #include <vector>
 #include <cstdint>
 
@@ -84,6 +85,30 @@ public:
 
     bool getProperty(ObjectProperty prop) const noexcept;
 
+    /// The deepest value stack that any expression of the behavior needs.
+    std::size_t getStackDepth() const noexcept;
+
+    /// activate() changes nothing and draws no random values
+    bool isInert() const noexcept;
+
+    /// Whether activate() looks the outcome up instead of interpreting,
+    /// see buildMemo()
+    bool isMemoized() const noexcept;
+
+    /// Zero for the 'void' behavior, otherwise getConditionCount() + 1
+    std::size_t getCommandCount() const noexcept;
+
+    std::size_t getConditionCount() const noexcept;
+
+    const std::vector<std::uint32_t>& getConditionExpression(std::size_t index) const noexcept;
+
+    const std::vector<std::uint32_t>& getModifyExpression(std::size_t index) const noexcept;
+
+    ObjectCommand getCommand(std::size_t index) const noexcept;
+
+    /// Stack depth that activate() serves without allocating
+    static constexpr std::size_t InlineStackDepth = 64;
+
 private:
 
     enum class StackValueType {
@@ -94,9 +119,21 @@ private:
         CombinedDirection
     };
 
+    /// The values of the target and the arguments that a program can read
+    /// (besides the parameter, see EffectAttributeStates::paramType)
+    enum class ExecutionInput {
+        PreviousSnakeDirection,
+        SnakeDirection,
+        SnakeAcceleration,
+        Remembered,
+        Count
+    };
+
     /// Effect states to define the program attributes
     struct EffectAttributeStates {
+        std::bitset<(std::size_t)ExecutionInput::Count> inputs;
         bool requiresRandom = false;
+        std::size_t stackDepth = 0;
         ObjectParameterType paramType = ObjectParameterType::NoParameter;
     };
 
@@ -106,10 +143,54 @@ private:
                                 std::size_t keywordCount,
                                 EffectAttributeStates& states);
 
-    static std::uint32_t computeValueExpression(const std::uint32_t* program,
-                                                std::size_t keywordCount,
-                                                const ExecutionTarget& target,
-                                                const ExecutionArguments& arguments);
+    using Handler = std::uint32_t* (*)(std::uint32_t* top, std::uint32_t operand,
+                                       const ExecutionTarget& target,
+                                       const ExecutionArguments& arguments);
+
+    /// One pre-decoded keyword of the threaded code
+    struct Instruction {
+        Handler handler;
+        std::uint32_t operand;
+    };
+
+    /// [begin, end) of m_code
+    struct Program {
+        std::uint32_t begin = 0;
+        std::uint32_t end = 0;
+    };
+
+    /// Lowers a validated expression to threaded code:
+    /// folds the values that depend on neither the target nor the arguments
+    /// and fuses the comparisons of a load with a constant or the parameter.
+    static Program lowerValueExpression(const std::uint32_t* expression,
+                                        std::size_t keywordCount,
+                                        std::vector<Instruction>& code);
+
+    /// The chosen command and the value of its modify expression
+    struct Outcome {
+        ObjectCommand command = ObjectCommand::NoCommand;
+        std::uint32_t value = 0;
+    };
+
+    Outcome evaluate(const ExecutionTarget& target,
+                     const ExecutionArguments& arguments,
+                     std::uint32_t* stack) const;
+
+    static void applyOutcome(const Outcome& outcome, ExecutionTarget& target) noexcept;
+
+    /// Precomputes the outcome of a program without randomness and without
+    /// RememberedInt for every combination of the inputs it reads
+    void buildMemo(const EffectAttributeStates& states);
+
+    /// false if there is no memo or an input is out of its domain
+    bool getMemoIndex(const ExecutionTarget& target,
+                      const ExecutionArguments& arguments,
+                      std::size_t& index) const noexcept;
+
+    std::uint32_t execute(const Program& program,
+                          const ExecutionTarget& target,
+                          const ExecutionArguments& arguments,
+                          std::uint32_t* stack) const;
 
     using Expression = std::vector<std::uint32_t>;
 
@@ -117,7 +198,20 @@ private:
     std::vector<Expression> m_modifyExpressions;              // expressions can be empty, but the vector can't be
     std::vector<ObjectCommand> m_commands;          // if it's empty, there is 'empty behavior'
 
+    std::vector<Instruction> m_code;                //!< Threaded code of all the expressions
+    std::vector<Program> m_conditionPrograms;
+    std::vector<Program> m_modifyPrograms;          // empty if the command takes no value
+
+    // memo inputs: parameter, previous direction, direction, acceleration
+    static constexpr std::size_t MemoInputCount = 4;
+    static constexpr std::size_t MemoSizeLimit = 1024;
+
+    std::vector<Outcome> m_memo;                    //!< Mixed radix over the read inputs
+    std::array<std::uint32_t, MemoInputCount> m_memoDomains; //!< 0 if the input is not read
+    std::array<std::uint32_t, MemoInputCount> m_memoStrides;
+
     std::bitset<ObjectPropertyCount> m_properties;
+    std::size_t m_stackDepth;                       //!< Maximal depth of the value stack
     ObjectParameterType m_parameterType;            //!< The parameter type that the object requires
 };
 
@@ -24,7 +24,6 @@
 ////////////////////////////////////////////////////////////
 
 #include "SnakeWorld.hpp"
-#include <bw_ext/FenwickTree.hpp>
 #include <bw_ext/random/Randomizer.hpp>
 #include <bw_ext/ObjParamEnumUtility.hpp>
 #include "const/EventEnums.hpp"
@@ -33,69 +32,25 @@
 
 namespace {
 
-template<class Vec>
-sf::Vector2i getRandomPosition(const Vec& probMap,
-                               const sf::Vector2u& mapSize,
-                               Bulletworm::Randomizer& randomizer) {
-    using fwt = Bulletworm::FenwickTree<typename Vec::iterator,
-        typename Vec::const_iterator, std::ptrdiff_t, std::uintmax_t>;
-
-    std::uintmax_t modulo = fwt::getSum(probMap.begin(), probMap.size() - 1);
-    if (!modulo) return sf::Vector2i(mapSize);
-
-    std::uintmax_t random = randomizer.get(0, modulo - 1);
-    std::size_t target = fwt::rankQuery(probMap.begin(), probMap.end(), random);
-
-    sf::Vector2i result;
-    result.x = int(target % (std::size_t)mapSize.x);
-    result.y = int(target / (std::size_t)mapSize.x);
-    return result;
+// item cell: the index in the position vector and the item kind + 1 (0 is no item)
+std::uint32_t makeItemCell(Bulletworm::EatableItem item, std::size_t index) noexcept {
+    return ((std::uint32_t)index << 2) | ((std::uint32_t)item + 1);
 }
 
-void fwkCreate(std::vector<std::uintmax_t>& vec, const std::uint32_t* values,
-            std::size_t sz) {
-    using fwt = Bulletworm::FenwickTree<std::vector<std::uintmax_t>::iterator,
-        std::vector<std::uintmax_t>::const_iterator, std::ptrdiff_t, std::uintmax_t>;
-
-    constexpr auto realsize = [](std::size_t val) {
-        unsigned int bitlog = 0;
-        std::size_t tval = val ? val - 1 : 0;
-        while (tval) {
-            tval >>= 1;
-            ++bitlog;
-        }
-        return (std::size_t)1 + (val ? ((std::size_t)1u << bitlog) : 0);
-    };
-
-    vec.resize(realsize(sz));
-
-    std::copy(values, values + sz, vec.data() + 1);
-    std::fill(vec.data() + sz + 1, vec.data() + vec.size(), 0);
-    vec[0] = 0;
-    fwt::init(vec.begin(), vec.end());
+Bulletworm::EatableItem getItemCellKind(std::uint32_t cell) noexcept {
+    return Bulletworm::EatableItem((cell & 3) - 1);
 }
 
-void fwkReset(std::vector<std::uintmax_t>& vec, const std::uint32_t* values,
-              std::size_t sz) noexcept {
-    using fwt = Bulletworm::FenwickTree<std::vector<std::uintmax_t>::iterator,
-        std::vector<std::uintmax_t>::const_iterator, std::ptrdiff_t, std::uintmax_t>;
-
-    constexpr auto realsize = [](std::size_t val) {
-        unsigned int bitlog = 0;
-        std::size_t tval = val ? val - 1 : 0;
-        while (tval) {
-            tval >>= 1;
-            ++bitlog;
-        }
-        return (std::size_t)1 + (val ? ((std::size_t)1u << bitlog) : 0);
-    };
+std::size_t getItemCellIndex(std::uint32_t cell) noexcept {
+    return cell >> 2;
+}
 
-    assert(vec.size() == realsize(sz));
+const sf::Vector2i& getItemPosition(const sf::Vector2i& position) noexcept {
+    return position;
+}
 
-    std::copy(values, values + sz, vec.data() + 1);
-    std::fill(vec.data() + sz + 1, vec.data() + vec.size(), 0);
-    vec[0] = 0;
-    fwt::init(vec.begin(), vec.end());
+const sf::Vector2i& getItemPosition(const Bulletworm::SnakeWorld::PowerupPosition& position) noexcept {
+    return position.first;
 }
 
 }
@@ -119,14 +74,23 @@ void SnakeWorld::restart(const Map<std::uint32_t>* const* initItemProbArr,
         }
     }
 
+    dropSnapshots();
+
     // init
     std::copy(initItemProbArr,
               initItemProbArr + ItemCount,
               m_initItemProbabilities.begin());
 
+    std::size_t area = (std::size_t)getMapSize().x * getMapSize().y;
+
     createItemProbs();
+
+    // reverting more positions would be slower than the whole reset
+    m_itemAccessJournal.create(area, area / 8 + 64);
+
+    m_tailCells.reset(getMapSize(), area >= TriggerMapSize);
+    m_itemCells.reset(getMapSize(), area >= TriggerMapSize);
     postInit(snakePosition);
-    m_tailIDs.reset(getMapSize(), (std::size_t)getMapSize().x * getMapSize().y >= TriggerMapSize);
 }
 
 
@@ -146,20 +110,43 @@ void SnakeWorld::postInit(const sf::Vector2i& snakePosition) noexcept {
     m_powerupPositions.clear();
 
     m_stepCount = 0;
+    m_tailSize = 0;
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 void SnakeWorld::restart(const sf::Vector2i& snakePosition) noexcept {
-    resetItemProbs();
+    dropSnapshots();
+    revertItemProbs();
+    clearTail();
+    clearItemCells();
     postInit(snakePosition);
-    m_tailIDs.reset((std::size_t)getMapSize().x * getMapSize().y >= TriggerMapSize);
 }
 
 
-const SnakeWorld::TailIdSubList&
-SnakeWorld::getTailIDs(const sf::Vector2i& position) const noexcept {
-    return m_tailIDs.getList(position);
+void SnakeWorld::clearTail() noexcept {
+    // only the live tail has tail cells
+    for (std::uintmax_t id = m_stepCount - m_tailSize; id != m_stepCount; ++id)
+        m_tailCells.erase(getTailSegment(id).position);
+
+    m_tailSize = 0;
+}
+
+
+void SnakeWorld::clearItemCells() noexcept {
+    for (const auto& now : m_fruitPositions)
+        m_itemCells.erase(now);
+
+    for (const auto& now : m_bonusPositions)
+        m_itemCells.erase(now);
+
+    for (const auto& now : m_powerupPositions)
+        m_itemCells.erase(now.first);
+}
+
+
+SnakeWorld::TailIdRange SnakeWorld::getTailIDs(const sf::Vector2i& position) const noexcept {
+    return TailIdRange(this, m_tailCells.get(position).first);
 }
 
 void SnakeWorld::createItemProbs() {
@@ -167,26 +154,46 @@ void SnakeWorld::createItemProbs() {
     sf::Vector2i mapSize{ getMapSize() };
     std::size_t area = (std::size_t)mapSize.x * mapSize.y;
 
+    std::array<const std::uint32_t*, ItemCount> initValues{};
     for (int i = 0; i < ItemCount; ++i) {
         assert(getMapSize() == m_initItemProbabilities[i]->getSize());
-        fwkCreate(m_itemProbabilities[i],
-                  m_initItemProbabilities[i]->data(),
-                  area);
+        initValues[i] = m_initItemProbabilities[i]->data();
     }
+
+    m_itemProbabilities.create(area, initValues.data());
 }
 
 
 void SnakeWorld::resetItemProbs() noexcept {
     // item accesses
-    sf::Vector2i mapSize{ getMapSize() };
-    std::size_t area = (std::size_t)mapSize.x * mapSize.y;
-
+    std::array<const std::uint32_t*, ItemCount> initValues{};
     for (int i = 0; i < ItemCount; ++i) {
         assert(getMapSize() == m_initItemProbabilities[i]->getSize());
-        fwkReset(m_itemProbabilities[i],
-                  m_initItemProbabilities[i]->data(),
-                  area);
+        initValues[i] = m_initItemProbabilities[i]->data();
     }
+
+    m_itemProbabilities.reset(initValues.data());
+    m_itemAccessJournal.clear();
+}
+
+
+void SnakeWorld::revertItemProbs() noexcept {
+    if (m_itemAccessJournal.isOverflowed()) {
+        resetItemProbs();
+        return;
+    }
+
+    const sf::Vector2u& mapSize = getMapSize();
+
+    for (std::uint32_t cell : m_itemAccessJournal.getCells()) {
+        ItemProbTree::Leaf initValues;
+        for (int i = 0; i < ItemCount; ++i)
+            initValues[i] = m_initItemProbabilities[i]->at(int(cell % mapSize.x), int(cell / mapSize.x));
+
+        m_itemProbabilities.restoreAll(cell, initValues);
+    }
+
+    m_itemAccessJournal.clear();
 }
 
 
@@ -203,9 +210,6 @@ std::uintmax_t SnakeWorld::moveSnake(Direction direction) {
 
     // Save the previous states
     sf::Vector2i previousPosition = m_snakePosition;
-    sf::Vector2i previousNeckPosition;
-    if (m_previousSnakeDirection != Direction::Count)
-        previousNeckPosition = getNeckPosition();
 
     // Move Snake
     moveOnModulus(m_snakePosition, direction, sf::Vector2i(mapSize));
@@ -213,18 +217,15 @@ std::uintmax_t SnakeWorld::moveSnake(Direction direction) {
     // Set the tail
 
     TailDirection tailDirection{};
-    const auto& prevNeckList = m_tailIDs.getList(previousNeckPosition);
 
-    // add 'entry'
-    if (m_previousSnakeDirection != Direction::Count && !prevNeckList.empty())
-        tailDirection.tdentry = prevNeckList.rbegin()->second.tdexit;
-
-    auto& prevList = m_tailIDs.setList(previousPosition);
+    // add 'entry' (the newest element is on the previous neck position)
+    if (m_previousSnakeDirection != Direction::Count && m_tailSize)
+        tailDirection.tdentry = getTailSegment(m_stepCount - 1).direction.tdexit;
 
     // add 'exit'
     tailDirection.tdexit = direction;
 
-    prevList.push_back(std::pair(m_stepCount, tailDirection));
+    pushTailSegment(TailSegment{ previousPosition, tailDirection, NoStep });
 
     m_previousSnakeDirection = direction;
 
@@ -235,14 +236,23 @@ std::uintmax_t SnakeWorld::moveSnake(Direction direction) {
     std::uintmax_t events = 0;
     constexpr std::uintmax_t MAX_ONE = 1;
 
-    if (m_fruitPositions.find(m_snakePosition) != m_fruitPositions.end())
-        events |= (MAX_ONE << (int)GameSubevent::FruitEaten);
-
-    if (m_bonusPositions.find(m_snakePosition) != m_bonusPositions.end())
-        events |= (MAX_ONE << (int)GameSubevent::BonusEaten);
-
-    if (m_powerupPositions.find(m_snakePosition) != m_powerupPositions.end())
-        events |= (MAX_ONE << (int)GameSubevent::PowerupEaten);
+    std::uint32_t itemCell = m_itemCells.get(m_snakePosition);
+
+    if (itemCell) {
+        switch (getItemCellKind(itemCell)) {
+        case EatableItem::Fruit:
+            events |= (MAX_ONE << (int)GameSubevent::FruitEaten);
+            break;
+        case EatableItem::Bonus:
+            events |= (MAX_ONE << (int)GameSubevent::BonusEaten);
+            break;
+        case EatableItem::Powerup:
+            events |= (MAX_ONE << (int)GameSubevent::PowerupEaten);
+            break;
+        default:
+            break;
+        }
+    }
 
     // Add the step
     ++m_stepCount;
@@ -255,16 +265,25 @@ void SnakeWorld::trimTail() noexcept {
     assert(getTailSize());
 
     const sf::Vector2u& mapSize = getMapSize();
-    auto& backList = m_tailIDs.setList(m_backPosition);
-
-    // open access
-    if (backList.size() == 1)
-        openAccess(m_backPosition);
+    std::uintmax_t backStepId = m_stepCount - m_tailSize;
+    const TailSegment& backSegment = getTailSegment(backStepId);
+    assert(backSegment.position == m_backPosition);
 
-    Direction backDir = backList.begin()->second.tdexit;
+    Direction backDir = backSegment.direction.tdexit;
 
     // from tail ids
-    backList.erase(backList.begin());
+    trailTailCell(m_backPosition);
+
+    if (backSegment.nextVisit == NoStep) {
+        m_tailCells.erase(m_backPosition);
+
+        // open access
+        openAccess(m_backPosition);
+    } else {
+        m_tailCells.set(m_backPosition).first = backSegment.nextVisit;
+    }
+
+    --m_tailSize;
 
     // back position forward
     moveOnModulus(m_backPosition, backDir, sf::Vector2i(mapSize));
@@ -280,7 +299,9 @@ void SnakeWorld::placeFruit(Randomizer& positionRandomizer) {
         return;
 
     closeAccess(randPos);
-    m_fruitPositions.insert(randPos);
+    trailItemCell(randPos);
+    m_itemCells.set(randPos) = makeItemCell(EatableItem::Fruit, m_fruitPositions.size());
+    pushItem(m_fruitPositions, EatableItem::Fruit, randPos);
 }
 
 
@@ -293,7 +314,9 @@ void SnakeWorld::placeBonus(Randomizer& positionRandomizer) {
         return;
 
     closeAccess(randPos);
-    m_bonusPositions.insert(randPos);
+    trailItemCell(randPos);
+    m_itemCells.set(randPos) = makeItemCell(EatableItem::Bonus, m_bonusPositions.size());
+    pushItem(m_bonusPositions, EatableItem::Bonus, randPos);
 }
 
 
@@ -306,76 +329,300 @@ void SnakeWorld::placePowerup(Randomizer& positionRandomizer, PowerupType certai
         return;
 
     closeAccess(randPos);
-    auto pair{ std::pair(randPos, certainPowerup) };
-    m_powerupPositions.insert(pair);
+    trailItemCell(randPos);
+    m_itemCells.set(randPos) = makeItemCell(EatableItem::Powerup, m_powerupPositions.size());
+    pushItem(m_powerupPositions, EatableItem::Powerup, PowerupPosition(randPos, certainPowerup));
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 void SnakeWorld::removeItem(const sf::Vector2i& position) {
-    auto fruitFound = m_fruitPositions.find(position);
-    auto bonusFound = m_bonusPositions.find(position);
-    auto powerupFound = m_powerupPositions.find(position);
-
-    if (fruitFound != m_fruitPositions.end())
-        m_fruitPositions.erase(fruitFound);
-    else if (bonusFound != m_bonusPositions.end())
-        m_bonusPositions.erase(bonusFound);
-    else if (powerupFound != m_powerupPositions.end())
-        m_powerupPositions.erase(powerupFound);
-    else
+    std::uint32_t itemCell = m_itemCells.get(position);
+
+    if (!itemCell)
         return;
 
+    std::size_t index = getItemCellIndex(itemCell);
+
+    switch (getItemCellKind(itemCell)) {
+    case EatableItem::Fruit:
+        swapRemoveItem(m_fruitPositions, index, EatableItem::Fruit);
+        break;
+    case EatableItem::Bonus:
+        swapRemoveItem(m_bonusPositions, index, EatableItem::Bonus);
+        break;
+    case EatableItem::Powerup:
+        swapRemoveItem(m_powerupPositions, index, EatableItem::Powerup);
+        break;
+    default:
+        break;
+    }
+
+    trailItemCell(position);
+    m_itemCells.erase(position);
+
     if (position != m_snakePosition &&
-        m_tailIDs.getList(position).empty())
+        getTailIDs(position).empty())
         openAccess(position);
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 void SnakeWorld::clearBonuses() noexcept {
-    for (const auto& now : m_bonusPositions)
+    for (const auto& now : m_bonusPositions) {
+        trailItemCell(now);
+        m_itemCells.erase(now);
+
         if (now != m_snakePosition &&
-            m_tailIDs.getList(now).empty())
+            getTailIDs(now).empty())
             openAccess(now);
+    }
 
-    m_bonusPositions.clear();
+    clearItems(m_bonusPositions, EatableItem::Bonus);
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 void SnakeWorld::clearPowerups() noexcept {
-    for (const auto& now : m_powerupPositions)
+    for (const auto& now : m_powerupPositions) {
+        trailItemCell(now.first);
+        m_itemCells.erase(now.first);
+
         if (now.first != m_snakePosition &&
-            m_tailIDs.getList(now.first).empty())
+            getTailIDs(now.first).empty())
             openAccess(now.first);
+    }
 
-    m_powerupPositions.clear();
+    clearItems(m_powerupPositions, EatableItem::Powerup);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class Vec>
+void SnakeWorld::swapRemoveItem(Vec& positions, std::size_t index, EatableItem item) {
+    // the last one takes the place
+    if (index + 1 != positions.size()) {
+        trailItem(ItemUndoOp::Set, item, index, positions[index]);
+        positions[index] = positions.back();
+        trailItemCell(getItemPosition(positions[index]));
+        m_itemCells.set(getItemPosition(positions[index])) = makeItemCell(item, index);
+    }
+
+    trailItem(ItemUndoOp::Pop, item, positions.size() - 1, positions.back());
+    positions.pop_back();
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 std::uintmax_t SnakeWorld::getTailSize() const noexcept {
-    if (m_previousSnakeDirection == Direction::Count)
-        return 0;
+    return m_tailSize;
+}
 
-    sf::Vector2i neckPos = getNeckPosition();
-    const auto& neck = m_tailIDs.getList(neckPos);
 
-    if (neck.empty())
-        return 0;
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void SnakeWorld::pushTailSegment(const TailSegment& segment) {
+    // grow the ring, the live step IDs keep their slots modulo the new size
+    if (m_tailSize == m_tail.size()) {
+        std::vector<TailSegment> grown(std::max((std::size_t)16, m_tail.size() * 2));
+
+        for (std::uintmax_t id = m_stepCount - m_tailSize; id != m_stepCount; ++id)
+            grown[id & (grown.size() - 1)] = getTailSegment(id);
+
+        m_tail.swap(grown);
+    }
+
+    // the slot of the step a ring size ago
+    if (m_stepCount >= m_tail.size())
+        trailTailSegment(m_stepCount - m_tail.size());
+
+    m_tail[m_stepCount & (m_tail.size() - 1)] = segment;
+    ++m_tailSize;
+
+    trailTailCell(segment.position);
+    TailCell& cell = m_tailCells.set(segment.position);
+
+    if (cell.first == NoStep) {
+        cell.first = m_stepCount;
+    } else {
+        trailTailSegment(cell.last);
+        m_tail[cell.last & (m_tail.size() - 1)].nextVisit = m_stepCount;
+    }
+
+    cell.last = m_stepCount;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+SnakeWorld::Snapshot SnakeWorld::takeSnapshot() noexcept {
+    m_trailing = true;
+
+    Snapshot snapshot;
+    snapshot.tailMark = m_tailUndo.getMark();
+    snapshot.tailCellMark = m_tailCellUndo.getMark();
+    snapshot.itemCellMark = m_itemCellUndo.getMark();
+    snapshot.itemAccessMark = m_itemAccessUndo.getMark();
+    snapshot.itemMark = m_itemUndo.getMark();
+    snapshot.stepCount = m_stepCount;
+    snapshot.tailSize = m_tailSize;
+    snapshot.snakePosition = m_snakePosition;
+    snapshot.backPosition = m_backPosition;
+    snapshot.previousSnakeDirection = m_previousSnakeDirection;
+    return snapshot;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void SnakeWorld::restoreSnapshot(const Snapshot& snapshot) {
+    // the ring never shrinks, so the slot of a step is taken modulo the current size
+    m_tailUndo.rewind(snapshot.tailMark, [this](std::size_t stepId, const TailSegment& segment) {
+        m_tail[stepId & (m_tail.size() - 1)] = segment;
+    });
+
+    m_tailCellUndo.rewind(snapshot.tailCellMark, [this](std::size_t index, const TailCell& cell) {
+        if (cell.first == NoStep)
+            m_tailCells.erase(m_tailCells.getPosition(index));
+        else
+            m_tailCells.set(m_tailCells.getPosition(index)) = cell;
+    });
+
+    m_itemCellUndo.rewind(snapshot.itemCellMark, [this](std::size_t index, std::uint32_t cell) {
+        if (!cell)
+            m_itemCells.erase(m_itemCells.getPosition(index));
+        else
+            m_itemCells.set(m_itemCells.getPosition(index)) = cell;
+    });
+
+    // the restart journal has already marked them
+    m_itemAccessUndo.rewind(snapshot.itemAccessMark, [this](std::size_t index, const ItemProbTree::Leaf& leaf) {
+        m_itemProbabilities.setAll(index, leaf);
+    });
+
+    m_itemUndo.rewind(snapshot.itemMark, [this](std::size_t slot, const PowerupPosition& value) {
+        auto item = EatableItem(slot & 3);
+        auto op = ItemUndoOp((slot >> 2) & 3);
+        std::size_t index = slot >> 4;
+
+        auto undo = [op, index](auto& positions, const auto& previous) {
+            switch (op) {
+            case ItemUndoOp::Push:
+                positions.pop_back();
+                break;
+            case ItemUndoOp::Set:
+                positions[index] = previous;
+                break;
+            case ItemUndoOp::Pop:
+                positions.push_back(previous);
+                break;
+            default:
+                break;
+            }
+        };
+
+        switch (item) {
+        case EatableItem::Fruit:
+            undo(m_fruitPositions, value.first);
+            break;
+        case EatableItem::Bonus:
+            undo(m_bonusPositions, value.first);
+            break;
+        case EatableItem::Powerup:
+            undo(m_powerupPositions, value);
+            break;
+        default:
+            break;
+        }
+    });
+
+    m_stepCount = snapshot.stepCount;
+    m_tailSize = snapshot.tailSize;
+    m_snakePosition = snapshot.snakePosition;
+    m_backPosition = snapshot.backPosition;
+    m_previousSnakeDirection = snapshot.previousSnakeDirection;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void SnakeWorld::dropSnapshots() noexcept {
+    m_tailUndo.clear();
+    m_tailCellUndo.clear();
+    m_itemCellUndo.clear();
+    m_itemAccessUndo.clear();
+    m_itemUndo.clear();
+    m_trailing = false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void SnakeWorld::trailTailSegment(std::uintmax_t stepId) {
+    if (m_trailing)
+        m_tailUndo.push((std::size_t)stepId, getTailSegment(stepId));
+}
+
+
+void SnakeWorld::trailTailCell(const sf::Vector2i& position) {
+    if (m_trailing)
+        m_tailCellUndo.push(m_tailCells.getIndex(position), m_tailCells.get(position));
+}
+
+
+void SnakeWorld::trailItemCell(const sf::Vector2i& position) {
+    if (m_trailing)
+        m_itemCellUndo.push(m_itemCells.getIndex(position), m_itemCells.get(position));
+}
 
-    std::uint64_t thenewest = neck.rbegin()->first;
-    std::uint64_t theoldest = m_tailIDs.getList(m_backPosition).begin()->first;
-    return thenewest + 1 - theoldest;
+
+void SnakeWorld::trailItemAccess(std::size_t valueIndex) {
+    if (m_trailing)
+        m_itemAccessUndo.push(valueIndex, m_itemProbabilities.getLeaf(valueIndex));
+}
+
+
+void SnakeWorld::trailItem(ItemUndoOp op, EatableItem item, std::size_t index,
+                           const PowerupPosition& value) {
+    if (m_trailing)
+        m_itemUndo.push((index << 4) | ((std::size_t)op << 2) | (std::size_t)item, value);
+}
+
+
+void SnakeWorld::trailItem(ItemUndoOp op, EatableItem item, std::size_t index,
+                           const sf::Vector2i& value) {
+    if (m_trailing)
+        trailItem(op, item, index, PowerupPosition(value, PowerupType()));
+}
+
+
+template<class Vec>
+void SnakeWorld::pushItem(Vec& positions, EatableItem item, const typename Vec::value_type& value) {
+    trailItem(ItemUndoOp::Push, item, positions.size(), value);
+    positions.push_back(value);
+}
+
+
+template<class Vec>
+void SnakeWorld::clearItems(Vec& positions, EatableItem item) {
+    // the newest first on the rewind: the front one is pushed back first
+    for (std::size_t i = positions.size(); i-- > 0;)
+        trailItem(ItemUndoOp::Pop, item, i, positions[i]);
+
+    positions.clear();
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 sf::Vector2i SnakeWorld::getAvailablePosition(EatableItem item, Randomizer& randomizer) const {
     auto itemIndex = (std::size_t)item;
-    const auto& itemProb = m_itemProbabilities[itemIndex];
-    return getRandomPosition(itemProb, getMapSize(), randomizer);
+    const sf::Vector2u& mapSize = getMapSize();
+
+    std::uintmax_t modulo = m_itemProbabilities.getTotal(itemIndex);
+    if (!modulo) return sf::Vector2i(mapSize);
+
+    std::uintmax_t random = randomizer.get(0, modulo - 1);
+    std::size_t target = m_itemProbabilities.rankQuery(itemIndex, random);
+
+    sf::Vector2i result;
+    result.x = int(target % (std::size_t)mapSize.x);
+    result.y = int(target / (std::size_t)mapSize.x);
+    return result;
 }
 
 
@@ -393,39 +640,42 @@ sf::Vector2i SnakeWorld::getNeckPosition() const noexcept {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 void SnakeWorld::setAccess(int x, int y, EatableItem item, std::uint32_t access) noexcept {
-    std::size_t itemIndex = (std::size_t)item;
-    const auto& mapSize = getMapSize();
-    std::size_t valueIndex = x + (std::size_t)y * mapSize.x;
-
-    using fwt = Bulletworm::FenwickTree<std::vector<std::uintmax_t>::iterator,
-        std::vector<std::uintmax_t>::const_iterator, std::ptrdiff_t, std::uintmax_t>;
-
-    fwt::update(m_itemProbabilities[itemIndex].begin(),
-                m_itemProbabilities[itemIndex].end(),
-                valueIndex + 1, (std::uintmax_t)access - fwt::get(m_itemProbabilities[itemIndex].begin(),
-                valueIndex)); // not bug, but feature
+    std::size_t valueIndex = x + (std::size_t)y * getMapSize().x;
+    m_itemAccessJournal.mark(valueIndex);
+    trailItemAccess(valueIndex);
+    m_itemProbabilities.set((std::size_t)item, valueIndex, access);
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 void SnakeWorld::closeAccess(int x, int y) noexcept {
-    for (int i = 0; i < ItemCount; ++i)
-        setAccess(x, y, EatableItem(i), 0);
+    std::size_t valueIndex = x + (std::size_t)y * getMapSize().x;
+    m_itemAccessJournal.mark(valueIndex);
+    trailItemAccess(valueIndex);
+    m_itemProbabilities.closeAll(valueIndex);
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 void SnakeWorld::openAccess(int x, int y) noexcept {
-    for (int i = 0; i < ItemCount; ++i) {
-        const auto& initItemProb = m_initItemProbabilities[i];
-        setAccess(x, y, EatableItem(i), initItemProb->at(x, y));
-    }
+    ItemProbTree::Leaf initValues;
+    for (int i = 0; i < ItemCount; ++i)
+        initValues[i] = m_initItemProbabilities[i]->at(x, y);
+
+    std::size_t valueIndex = x + (std::size_t)y * getMapSize().x;
+    m_itemAccessJournal.mark(valueIndex);
+    trailItemAccess(valueIndex);
+    m_itemProbabilities.restoreAll(valueIndex, initValues);
 }
 
 
 SnakeWorld::SnakeWorld(SnakeWorld&& src) noexcept :
-    m_tailIDs(std::move(src.m_tailIDs)),
+    m_tail(std::move(src.m_tail)),
+    m_tailSize(src.m_tailSize),
+    m_tailCells(std::move(src.m_tailCells)),
     m_itemProbabilities(std::move(src.m_itemProbabilities)),
+    m_itemAccessJournal(std::move(src.m_itemAccessJournal)),
+    m_itemCells(std::move(src.m_itemCells)),
     m_fruitPositions(std::move(src.m_fruitPositions)),
     m_bonusPositions(std::move(src.m_bonusPositions)),
     m_powerupPositions(std::move(src.m_powerupPositions)),
@@ -433,8 +683,16 @@ SnakeWorld::SnakeWorld(SnakeWorld&& src) noexcept :
     m_stepCount(src.m_stepCount),
     m_snakePosition(src.m_snakePosition),
     m_backPosition(src.m_backPosition),
-    m_previousSnakeDirection(src.m_previousSnakeDirection) {
+    m_previousSnakeDirection(src.m_previousSnakeDirection),
+    m_tailUndo(std::move(src.m_tailUndo)),
+    m_tailCellUndo(std::move(src.m_tailCellUndo)),
+    m_itemCellUndo(std::move(src.m_itemCellUndo)),
+    m_itemAccessUndo(std::move(src.m_itemAccessUndo)),
+    m_itemUndo(std::move(src.m_itemUndo)),
+    m_trailing(src.m_trailing) {
     src.m_stepCount = 0;
+    src.m_tailSize = 0;
+    src.m_trailing = false;
 }
 
 
@@ -447,13 +705,25 @@ SnakeWorld& SnakeWorld::operator=(SnakeWorld&& src) noexcept {
     m_fruitPositions = std::move(src.m_fruitPositions);
     m_initItemProbabilities = std::move(src.m_initItemProbabilities);
     m_itemProbabilities = std::move(src.m_itemProbabilities);
+    m_itemAccessJournal = std::move(src.m_itemAccessJournal);
     m_powerupPositions = std::move(src.m_powerupPositions);
+    m_itemCells = std::move(src.m_itemCells);
     m_previousSnakeDirection = src.m_previousSnakeDirection;
     m_snakePosition = src.m_snakePosition;
     m_stepCount = src.m_stepCount;
-    m_tailIDs = std::move(src.m_tailIDs);
+    m_tail = std::move(src.m_tail);
+    m_tailSize = src.m_tailSize;
+    m_tailCells = std::move(src.m_tailCells);
+    m_tailUndo = std::move(src.m_tailUndo);
+    m_tailCellUndo = std::move(src.m_tailCellUndo);
+    m_itemCellUndo = std::move(src.m_itemCellUndo);
+    m_itemAccessUndo = std::move(src.m_itemAccessUndo);
+    m_itemUndo = std::move(src.m_itemUndo);
+    m_trailing = src.m_trailing;
 
     src.m_stepCount = 0;
+    src.m_tailSize = 0;
+    src.m_trailing = false;
 
     return *this;
 }
@@ -471,11 +741,7 @@ Direction SnakeWorld::getPreviousDirection() const noexcept {
 
 std::uint32_t SnakeWorld::getCurrentRelativeItemAcquireProb(EatableItem item, 
                                                             int x, int y) const noexcept {
-    using fwt = Bulletworm::FenwickTree<std::vector<std::uintmax_t>::iterator,
-        std::vector<std::uintmax_t>::const_iterator, std::ptrdiff_t, std::uintmax_t>;
-
-    return (std::uint32_t)fwt::get(m_itemProbabilities[(std::size_t)item].begin(),
-                    (std::ptrdiff_t)x + (std::ptrdiff_t)y * getMapSize().x);
+    return m_itemProbabilities.get((std::size_t)item, x + (std::size_t)y * getMapSize().x);
 }
 
 
@@ -516,63 +782,45 @@ void SnakeWorld::closeAccess(const sf::Vector2i& position) noexcept {
     closeAccess(position.x, position.y);
 }
 
-void SnakeWorld::TaidIdContainer::reset(const sf::Vector2u& newsize, bool enable_map) 
+template<class T>
+void SnakeWorld::CellContainer<T>::reset(const sf::Vector2u& newsize, bool enable_map)
 {
-    if (is_map && enable_map) {
-        TailIdMap().swap(map);
-    } else if (!is_map && enable_map) {
-        TailIdVector().swap(vector);
-    } else if (is_map && !enable_map) {
-        TailIdMap().swap(map);
-        TailIdVector((std::size_t)newsize.x * newsize.y).swap(vector);
+    if (enable_map) {
+        std::vector<T>().swap(vector);
+        map.create(newsize, T{});
     } else {
-        TailIdVector().swap(vector);
-        vector.resize((std::size_t)newsize.x * newsize.y);
+        map = PagedMap<T>();
+        vector.assign((std::size_t)newsize.x * newsize.y, T{});
     }
     size = newsize;
     is_map = enable_map;
 }
 
-void SnakeWorld::TaidIdContainer::reset(bool enable_map) noexcept {
-    if (is_map && enable_map) {
-        TailIdMap().swap(map);
-    } else if (!is_map && enable_map) {
-        TailIdVector().swap(vector);
-    } else if (is_map && !enable_map) {
-        TailIdMap().swap(map);
-        TailIdVector((std::size_t)size.x * size.y).swap(vector);
+template<class T>
+T SnakeWorld::CellContainer<T>::get(const sf::Vector2i& position) const noexcept {
+    if (is_map) {
+        return map.at(position.x, position.y);
     } else {
-        TailIdVector().swap(vector);
-        std::for_each(vector.begin(), vector.end(),
-                      [](TailIdSubList& item) {
-                          TailIdSubList().swap(item);
-                      });
+        return vector[position.x + (std::size_t)position.y * size.x];
     }
-    is_map = enable_map;
 }
 
-const SnakeWorld::TailIdSubList& SnakeWorld::TaidIdContainer::getList(const sf::Vector2i& position)
-const noexcept {
+template<class T>
+T& SnakeWorld::CellContainer<T>::set(const sf::Vector2i& position) {
     if (is_map) {
-        auto iter = map.find(position);
-        
-        if (iter == map.end())
-            return VirtualSublist;
-
-        return iter->second;
+        return map.set(position.x, position.y);
     } else {
         return vector[position.x + (std::size_t)position.y * size.x];
     }
 }
 
-SnakeWorld::TailIdSubList& SnakeWorld::TaidIdContainer::setList(const sf::Vector2i& position) {
+template<class T>
+void SnakeWorld::CellContainer<T>::erase(const sf::Vector2i& position) noexcept {
     if (is_map) {
-        return map[position];
+        map.erase(position.x, position.y);
     } else {
-        return vector[position.x + (std::size_t)position.y * size.x];
+        vector[position.x + (std::size_t)position.y * size.x] = T{};
     }
 }
 
-const SnakeWorld::TailIdSubList SnakeWorld::TaidIdContainer::VirtualSublist;
-
 } // namespace Bulletworm
\ No newline at end of file
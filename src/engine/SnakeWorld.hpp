@@ -30,11 +30,15 @@
 #include "const/EatableItem.hpp"
 #include <bw_ext/const/ObjectParameterEnums.hpp>
 #include <bw_ext/Map.hpp>
+#include <bw_ext/PagedMap.hpp>
+#include <bw_ext/FenwickSampler.hpp>
+#include <bw_ext/CellJournal.hpp>
+#include <bw_ext/UndoTrail.hpp>
 #include <array>
 #include <vector>
-#include <unordered_set>
-#include <unordered_map>
-#include <list>
+#include <iterator>
+#include <limits>
+#include <utility>
 
 namespace Bulletworm {
 class Randomizer;
@@ -51,33 +55,144 @@ public:
         Direction tdexit;  // |   >|
     };
 
-    struct Vector2iHash {
-        union Union {
-            int val;
-            std::size_t h;
-        };
-        std::size_t operator()(const sf::Vector2i& keyval) const noexcept {
-            if constexpr (sizeof(int) * 2 == sizeof(std::size_t)) {
-                Union un{};
-                un.val = keyval.x;
-                un.h <<= 32;
-                std::size_t h = un.h;
-                un.val = keyval.y;
-                h |= un.h;
-                return h;
+    // Read-only view of contiguous elements
+    template<class T>
+    class ElementRange {
+    public:
+
+        ElementRange(const T* first, const T* last) noexcept :
+            m_first(first), m_last(last) {}
+
+        const T* begin() const noexcept {
+            return m_first;
+        }
+
+        const T* end() const noexcept {
+            return m_last;
+        }
+
+        bool empty() const noexcept {
+            return m_first == m_last;
+        }
+
+        std::size_t size() const noexcept {
+            return std::size_t(m_last - m_first);
+        }
+
+    private:
+        const T* m_first;
+        const T* m_last;
+    };
+
+    using PowerupPosition = std::pair<sf::Vector2i, PowerupType>;
+    using ItemPositions = ElementRange<sf::Vector2i>;
+    using PowerupPositions = ElementRange<PowerupPosition>;
+
+    // (step ID, tail direction)
+    using TailId = std::pair<std::uintmax_t, TailDirection>;
+
+    static constexpr std::uintmax_t NoStep = std::numeric_limits<std::uintmax_t>::max();
+
+    // One tail element, the head left its position on the step ID
+    struct TailSegment {
+        sf::Vector2i position;
+        TailDirection direction;
+        std::uintmax_t nextVisit; // the next step ID on the same position or NoStep
+    };
+
+    // Step IDs of the tail elements on one position (the oldest and the newest ones)
+    struct TailCell {
+        std::uintmax_t first = NoStep;
+        std::uintmax_t last = NoStep;
+    };
+
+    // Tail IDs on one position from the oldest to the newest
+    class TailIdRange {
+    public:
+
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = TailId;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = TailId;
+
+            Iterator() noexcept = default;
+            Iterator(const SnakeWorld* world, std::uintmax_t stepId) noexcept :
+                m_world(world), m_stepId(stepId) {}
+
+            TailId operator*() const noexcept {
+                return TailId(m_stepId, m_world->getTailSegment(m_stepId).direction);
+            }
+
+            Iterator& operator++() noexcept {
+                m_stepId = m_world->getTailSegment(m_stepId).nextVisit;
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept {
+                Iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            bool operator==(const Iterator& other) const noexcept {
+                return m_stepId == other.m_stepId;
+            }
+
+            bool operator!=(const Iterator& other) const noexcept {
+                return m_stepId != other.m_stepId;
             }
-            return
-                std::hash<int>()(keyval.x) ^
-                std::hash<int>()(-keyval.y);
+
+        private:
+            const SnakeWorld* m_world = nullptr;
+            std::uintmax_t m_stepId = NoStep;
+        };
+
+        TailIdRange(const SnakeWorld* world, std::uintmax_t first) noexcept :
+            m_world(world), m_first(first) {}
+
+        Iterator begin() const noexcept {
+            return Iterator(m_world, m_first);
+        }
+
+        Iterator end() const noexcept {
+            return Iterator(m_world, NoStep);
+        }
+
+        bool empty() const noexcept {
+            return m_first == NoStep;
         }
+
+        // the oldest one, must not be empty
+        TailId front() const noexcept {
+            return *begin();
+        }
+
+        // O(the count)
+        std::size_t size() const noexcept {
+            return (std::size_t)std::distance(begin(), end());
+        }
+
+    private:
+        const SnakeWorld* m_world;
+        std::uintmax_t m_first;
     };
 
-    using ItemSet = std::unordered_set<sf::Vector2i, Vector2iHash>;
-    using PowerupMap = std::unordered_map<sf::Vector2i, PowerupType, Vector2iHash>;
-    
-    using TailIdSubList = std::list<std::pair<std::uintmax_t, TailDirection>>;
-    using TailIdVector = std::vector<TailIdSubList>;
-    using TailIdMap = std::unordered_map<sf::Vector2i, TailIdSubList, Vector2iHash>;
+    // The marks of the undo trails and the few scalar states, see takeSnapshot
+    struct Snapshot {
+        std::size_t tailMark = 0;
+        std::size_t tailCellMark = 0;
+        std::size_t itemCellMark = 0;
+        std::size_t itemAccessMark = 0;
+        std::size_t itemMark = 0;
+        std::uintmax_t stepCount = 0;
+        std::uintmax_t tailSize = 0;
+        sf::Vector2i snakePosition;
+        sf::Vector2i backPosition;
+        Direction previousSnakeDirection = Direction::Count;
+    };
 
     SnakeWorld() noexcept;
 
@@ -90,6 +205,8 @@ public:
     // create the world
     SnakeWorld(const Map<std::uint32_t>* const* initItemProbArr, const sf::Vector2i& snakePosition);
     void restart(const Map<std::uint32_t>* const* initItemProbArr, const sf::Vector2i& snakePosition);
+
+    // with the same (unchanged) maps, reverts only the touched positions
     void restart(const sf::Vector2i& snakePosition) noexcept;
 
     // if opposite, it will be just ignored
@@ -120,29 +237,53 @@ public:
     std::uintmax_t getTailSize() const noexcept;
     Direction getPreviousDirection() const noexcept;
 
-    const ItemSet& getFruitPositions() const noexcept {
-        return m_fruitPositions;
+    ItemPositions getFruitPositions() const noexcept {
+        return ItemPositions(m_fruitPositions.data(),
+                             m_fruitPositions.data() + m_fruitPositions.size());
     }
-    const ItemSet& getBonusPositions() const noexcept {
-        return m_bonusPositions;
+    ItemPositions getBonusPositions() const noexcept {
+        return ItemPositions(m_bonusPositions.data(),
+                             m_bonusPositions.data() + m_bonusPositions.size());
     }
-    const PowerupMap& getPowerups()       const noexcept {
-        return m_powerupPositions;
+    PowerupPositions getPowerups()       const noexcept {
+        return PowerupPositions(m_powerupPositions.data(),
+                                m_powerupPositions.data() + m_powerupPositions.size());
     }
     const sf::Vector2i& getBackPosition()   const noexcept {
         return m_backPosition;
     }
-    const TailIdSubList& getTailIDs(const sf::Vector2i& position) const noexcept;
+    TailIdRange getTailIDs(const sf::Vector2i& position) const noexcept;
+
+    // stepId must be in [getStepCount() - getTailSize(), getStepCount())
+    const TailSegment& getTailSegment(std::uintmax_t stepId) const noexcept {
+        return m_tail[stepId & (m_tail.size() - 1)];
+    }
 
     std::uintmax_t       getStepCount()      const noexcept {
         return m_stepCount;
     }
 
+    /// O(1). From now on every change records the previous value (until dropSnapshots),
+    /// the restarts drop the snapshots.
+    [[nodiscard]] Snapshot takeSnapshot() noexcept;
+
+    /// Back to the snapshot in O(the changes since), the snapshots taken after it become invalid
+    void restoreSnapshot(const Snapshot& snapshot);
+
+    /// Forget the snapshots and stop recording the changes
+    void dropSnapshots() noexcept;
+
 private:
 
     // technically two similar functions but one is with noexcept
     void createItemProbs();
     void resetItemProbs() noexcept;
+    void revertItemProbs() noexcept;
+    void clearTail() noexcept;
+    void clearItemCells() noexcept;
+
+    template<class Vec>
+    void swapRemoveItem(Vec& positions, std::size_t index, EatableItem item);
     void postInit(const sf::Vector2i& snakePosition) noexcept;
 
     /// Change the access of the map position.
@@ -162,43 +303,90 @@ private:
 
     sf::Vector2i getNeckPosition() const noexcept;
 
+    void pushTailSegment(const TailSegment& segment);
+
+    // Undo the position vector changes: pop_back, positions[index] = value, push_back(value)
+    enum class ItemUndoOp {
+        Push,
+        Set,
+        Pop
+    };
+
+    // Record the previous values before the changes if a snapshot is kept
+    void trailTailSegment(std::uintmax_t stepId);
+    void trailTailCell(const sf::Vector2i& position);
+    void trailItemCell(const sf::Vector2i& position);
+    void trailItemAccess(std::size_t valueIndex);
+
+    // The position vector changes, recorded
+    template<class Vec>
+    void pushItem(Vec& positions, EatableItem item, const typename Vec::value_type& value);
+    template<class Vec>
+    void clearItems(Vec& positions, EatableItem item);
+    void trailItem(ItemUndoOp op, EatableItem item, std::size_t index, const PowerupPosition& value);
+    void trailItem(ItemUndoOp op, EatableItem item, std::size_t index, const sf::Vector2i& value);
+
     ////////////////////////////////////////////////////////////
     /// Member data
     ////////////////////////////////////////////////////////////
 
-    class TaidIdContainer {
+    // Dense vector or paged map for the huge maps
+    template<class T>
+    class CellContainer {
     public:
 
         void reset(const sf::Vector2u& newsize, bool enable_map);
-        void reset(bool enable_map) noexcept;
 
-        const TailIdSubList& getList(const sf::Vector2i& position) const noexcept;
+        T get(const sf::Vector2i& position) const noexcept;
+        T& set(const sf::Vector2i& position);
+        void erase(const sf::Vector2i& position) noexcept;
 
-        TailIdSubList& setList(const sf::Vector2i& position) ;
+        // index is x + y * width
+        sf::Vector2i getPosition(std::size_t index) const noexcept {
+            return sf::Vector2i(int(index % size.x), int(index / size.x));
+        }
+        std::size_t getIndex(const sf::Vector2i& position) const noexcept {
+            return position.x + (std::size_t)position.y * size.x;
+        }
 
     private:
 
-        
-        TailIdMap map;
-        TailIdVector vector;
+        PagedMap<T> map; // the huge maps
+        std::vector<T> vector;
         sf::Vector2u size;
         bool is_map = true;
-        static const TailIdSubList VirtualSublist;
     };
 
-    TaidIdContainer m_tailIDs; // Tail IDs
-    std::array<std::vector<std::uintmax_t>, ItemCount> m_itemProbabilities; 
+    // Ring buffer indexed by (step ID & (size - 1)), the size is a power of two.
+    // Never shrinks, so the moves don't allocate once it is long enough.
+    std::vector<TailSegment> m_tail;
+    std::uintmax_t m_tailSize = 0;
+    CellContainer<TailCell> m_tailCells; // Tail IDs by position
+    using ItemProbTree = FenwickSampler<ItemCount>;
+
+    ItemProbTree m_itemProbabilities; 
     // For placing fruits, bonuses, powerups
-    
-    ItemSet m_fruitPositions; // Fruit position on the map
-    ItemSet m_bonusPositions; // Bonus position on the map
-    PowerupMap m_powerupPositions; // Powerup position on the map
+    CellJournal m_itemAccessJournal; // Changed item accesses since the restart
+
+    // Item kind (2 bits, 0 is no item) and the index in its position vector by position
+    CellContainer<std::uint32_t> m_itemCells;
+    std::vector<sf::Vector2i> m_fruitPositions; // Fruit position on the map
+    std::vector<sf::Vector2i> m_bonusPositions; // Bonus position on the map
+    std::vector<PowerupPosition> m_powerupPositions; // Powerup position on the map
     std::array<const Map<std::uint32_t>*, ItemCount> m_initItemProbabilities; // Dependencies
     std::uintmax_t m_stepCount = 0; // Total step count
     sf::Vector2i m_snakePosition; // Snake's head position on the map       
     sf::Vector2i m_backPosition; // Opens item access
     Direction m_previousSnakeDirection = Direction::Count; 
     // Previous snake direction (for rotate command processing)
+
+    // Undo trails of the snapshots, recorded only while m_trailing
+    UndoTrail<TailSegment> m_tailUndo;               // by the step ID
+    UndoTrail<TailCell> m_tailCellUndo;              // by the cell index
+    UndoTrail<std::uint32_t> m_itemCellUndo;         // by the cell index
+    UndoTrail<ItemProbTree::Leaf> m_itemAccessUndo;  // by the cell index
+    UndoTrail<PowerupPosition> m_itemUndo;           // by the index, op and item
+    bool m_trailing = false;
 };
 
 } // namespace Bulletworm
@@ -0,0 +1,265 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+#include "Autopilot.hpp"
+#include <bw_ext/random/RandomizerImpl.hpp>
+#include <bw_ext/ObjParamEnumUtility.hpp>
+#include <bw_ext/WorkerPool.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace Bulletworm;
+
+// (first command, second command) pairs, the work units of a decision
+constexpr unsigned int RootTaskCount = DirectionCount * DirectionCount;
+
+constexpr std::int64_t InvalidScore = std::numeric_limits<std::int64_t>::min();
+constexpr std::int64_t DeadScore = std::numeric_limits<std::int64_t>::min() / 2;
+
+using Randomizers = std::array<RandomizerImpl, RandomTypeCount>;
+
+// A lookahead copy of the played game
+struct Replica {
+    GameImpl game;
+    Randomizers randomizers;
+    std::uint64_t simulatedMoves = 0;
+
+    void sync(const GameImpl& source, const RandomizerImpl* sourceRandomizers) {
+        std::copy(sourceRandomizers, sourceRandomizers + RandomTypeCount, randomizers.begin());
+        game = source;
+
+        std::array<Randomizer*, RandomTypeCount> pointers{};
+        for (int i = 0; i < RandomTypeCount; ++i)
+            pointers[i] = &randomizers[i];
+
+        game.setRandomizers(pointers.data());
+    }
+
+    void step(Direction command) {
+        game.pushCommand(command);
+        game.move();
+        ++simulatedMoves;
+    }
+};
+
+
+// The opposite command is ignored by the engine, it is the same as going straight
+bool isUseful(const GameImpl& game, Direction command) noexcept {
+    Direction previous = game.getSnakeWorld().getPreviousDirection();
+    return previous == Direction::Count || command != oppositeDirection(previous);
+}
+
+
+// Longer is better, then closer to a fruit; the later death is the better one
+std::int64_t evaluate(const GameImpl& game, unsigned int ply) noexcept {
+    if (!game.isSnakeAlive())
+        return DeadScore + ply;
+
+    const SnakeWorld& world = game.getSnakeWorld();
+    sf::Vector2i head = world.getCurrentSnakePosition();
+
+    std::int64_t distance = 0;
+    if (!world.getFruitPositions().empty()) {
+        distance = std::numeric_limits<std::int64_t>::max();
+        for (const sf::Vector2i& fruit : world.getFruitPositions())
+            distance = std::min(distance, (std::int64_t)std::abs(fruit.x - head.x) + std::abs(fruit.y - head.y));
+    }
+
+    return (std::int64_t)game.getAimedTailSize() * 4096 - distance;
+}
+
+
+// The best leaf under the current state, the state is rewound back
+std::int64_t search(Replica& replica, unsigned int depth, unsigned int ply) {
+    if (!depth || !replica.game.isSnakeAlive())
+        return evaluate(replica.game, ply);
+
+    std::int64_t best = InvalidScore;
+
+    for (int i = 0; i < DirectionCount; ++i) {
+        if (!isUseful(replica.game, Direction(i)))
+            continue;
+
+        Randomizers randomizers = replica.randomizers;
+        GameImpl::Snapshot snapshot = replica.game.takeSnapshot();
+
+        replica.step(Direction(i));
+        best = std::max(best, search(replica, depth - 1, ply + 1));
+
+        replica.game.restoreSnapshot(snapshot);
+        replica.randomizers = randomizers;
+    }
+
+    return best;
+}
+
+
+std::int64_t searchRootTask(Replica& replica, Direction first, Direction second, unsigned int depth) {
+    if (!isUseful(replica.game, first))
+        return InvalidScore;
+
+    Randomizers randomizers = replica.randomizers;
+    GameImpl::Snapshot snapshot = replica.game.takeSnapshot();
+
+    replica.step(first);
+
+    std::int64_t score;
+    if (!replica.game.isSnakeAlive()) {
+        score = evaluate(replica.game, 1);
+    } else if (!isUseful(replica.game, second)) {
+        score = InvalidScore;
+    } else {
+        replica.step(second);
+        score = search(replica, depth - 2, 2);
+    }
+
+    replica.game.restoreSnapshot(snapshot);
+    replica.randomizers = randomizers;
+    return score;
+}
+
+}
+
+namespace Bulletworm {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+Autopilot::Report Autopilot::play(GameImpl& game,
+                                  RandomizerImpl* randomizers,
+                                  const std::uint32_t* objectMemory,
+                                  const Parameters& parameters) {
+    Report report;
+
+    unsigned int threadCount = parameters.threadCount;
+    if (!threadCount)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    // the root tasks are the only parallel work
+    threadCount = std::min(threadCount, RootTaskCount);
+    report.threadCount = threadCount;
+
+    unsigned int depth = std::max(parameters.depth, 2u);
+
+    // must not be reallocated: the games keep pointers to the randomizers
+    std::vector<Replica> replicas(threadCount);
+    std::array<std::int64_t, RootTaskCount> scores{};
+    std::atomic<unsigned int> nextTask{ 0 };
+
+    // how the replicas catch up with the game before the search
+    bool resync = true;
+    Direction lastCommand = Direction::Count;
+
+    std::function<void(unsigned int)> decide = [&](unsigned int worker) {
+        Replica& replica = replicas[worker];
+
+        if (resync) {
+            replica.sync(game, randomizers);
+        } else {
+            // the same command on the same state with the same randomizers
+            replica.game.pushCommand(lastCommand);
+            replica.game.move();
+            assert(replica.game.getSnakeWorld().getStepCount() == game.getSnakeWorld().getStepCount());
+        }
+
+        // the trails of the previous decision are not needed
+        replica.game.dropSnapshots();
+
+        unsigned int task;
+        while ((task = nextTask.fetch_add(1, std::memory_order_relaxed)) < RootTaskCount)
+            scores[task] = searchRootTask(replica, Direction(task / DirectionCount),
+                                          Direction(task % DirectionCount), depth);
+    };
+
+    WorkerPool pool(threadCount);
+
+    report.games = game.isSnakeAlive() ? 1 : 0;
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    for (;;) {
+        if (parameters.moveLimit && report.moves >= parameters.moveLimit)
+            break;
+
+        if (parameters.durationMcs && std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime).count() >= parameters.durationMcs)
+            break;
+
+        if (!game.isSnakeAlive()) {
+            game.restart(objectMemory);
+            ++report.games;
+            resync = true;
+        }
+
+        nextTask.store(0, std::memory_order_relaxed);
+        pool.run(decide);
+        ++report.decisions;
+
+        // the best first command, the current direction wins the ties
+        Direction command = Direction::Count;
+        std::int64_t best = InvalidScore;
+
+        for (unsigned int task = 0; task < RootTaskCount; ++task) {
+            Direction first = Direction(task / DirectionCount);
+
+            if (scores[task] > best || (scores[task] == best && scores[task] != InvalidScore &&
+                                        first == game.getSnakeDirection())) {
+                best = scores[task];
+                command = first;
+            }
+        }
+
+        assert(command != Direction::Count);
+
+        game.pushCommand(command);
+        game.move();
+        ++report.moves;
+
+        lastCommand = command;
+        resync = false;
+
+        report.maxTailSize = std::max(report.maxTailSize, game.getSnakeWorld().getTailSize());
+
+        if (!game.isSnakeAlive())
+            ++report.deaths;
+    }
+
+    report.elapsedMcs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    for (const Replica& replica : replicas)
+        report.simulatedMoves += replica.simulatedMoves;
+
+    return report;
+}
+
+} // namespace Bulletworm
@@ -0,0 +1,80 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+#ifndef AUTOPILOT_HPP
+#define AUTOPILOT_HPP
+#include "../engine/GameImpl.hpp"
+#include <cstdint>
+
+namespace Bulletworm {
+
+class RandomizerImpl;
+
+/// Built-in bot: before every move it searches the command sequences
+/// 'depth' moves ahead on snapshot-rewound copies of the game (one per worker
+/// thread) and pushes the first command of the best one.
+/// The lookahead runs the real engine (pushCommand + move), so the tail,
+/// obstacle and spike rules of the object behaviors apply as they are.
+/// The copies own copies of the randomizers: the bot foresees the items.
+/// The timed parts of Game (effect and item durations) are not simulated.
+class Autopilot {
+public:
+
+    struct Parameters {
+        unsigned int depth = 6;                // moves ahead, at least 2
+        unsigned int threadCount = 0;          // 0 means hardware concurrency
+        std::uint64_t moveLimit = 10000;       // over all games, 0 means unlimited
+        std::int64_t durationMcs = 0;          // wall clock budget, 0 means unlimited
+    };
+
+    struct Report {
+        std::uint64_t decisions = 0;
+        std::uint64_t moves = 0;               // played
+        std::uint64_t simulatedMoves = 0;      // in the lookahead
+        std::uint64_t games = 0;               // started
+        std::uint64_t deaths = 0;
+        std::uintmax_t maxTailSize = 0;
+        std::int64_t elapsedMcs = 0;
+        unsigned int threadCount = 0;
+
+        double getDecisionsPerSecond() const noexcept {
+            return elapsedMcs ? decisions * 1e6 / elapsedMcs : 0.;
+        }
+
+        double getSimulatedMovesPerSecond() const noexcept {
+            return elapsedMcs ? simulatedMoves * 1e6 / elapsedMcs : 0.;
+        }
+    };
+
+    /// Plays the started game until the limits, restarting it with objectMemory
+    /// after the deaths. randomizers are the RandomTypeCount ones of the game (by RandomizerType).
+    [[nodiscard]] static Report play(GameImpl& game,
+                                     RandomizerImpl* randomizers,
+                                     const std::uint32_t* objectMemory,
+                                     const Parameters& parameters);
+};
+
+} // namespace Bulletworm
+
+#endif // !AUTOPILOT_HPP
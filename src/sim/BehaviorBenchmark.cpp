@@ -0,0 +1,486 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include "BehaviorBenchmark.hpp"
+#include <bw_ext/random/RandomizerImpl.hpp>
+#include <bw_ext/const/ObjectParameterEnums.hpp>
+#include <bw_ext/ObjParamEnumUtility.hpp>
+#include <forward_list>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+using namespace Bulletworm;
+
+using ExecutionTarget = ObjectBehavior::ExecutionTarget;
+using ExecutionArguments = ObjectBehavior::ExecutionArguments;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// The interpreter as it was before the stack depth was computed at compile(),
+// kept verbatim as the reference
+std::uint32_t legacyComputeValueExpression(
+    const std::uint32_t* expression,
+    std::size_t keywordCount,
+    const ExecutionTarget& target,
+    const ExecutionArguments& arguments) {
+    std::forward_list<std::uint32_t> stack;
+    std::size_t pointer = 0;
+
+    bool isInteger = false;
+
+    bool again = true;
+    while (again) {
+        if (pointer >= keywordCount)
+            break;
+
+        if (isInteger) {
+            stack.push_front(expression[pointer]);
+            isInteger = false;
+        } else {
+            switch ((ObjectBehaviorKeyword)expression[pointer]) {
+            case ObjectBehaviorKeyword::AccelerationDefault:
+                stack.push_front((std::uint32_t)Acceleration::Default);
+                break;
+            case ObjectBehaviorKeyword::AccelerationDown:
+                stack.push_front((std::uint32_t)Acceleration::Down);
+                break;
+            case ObjectBehaviorKeyword::AccelerationUp:
+                stack.push_front((std::uint32_t)Acceleration::Up);
+                break;
+            case ObjectBehaviorKeyword::RandomAcceleration:
+                stack.push_front((std::uint32_t)arguments.randomizer->get(0, 
+                                 (std::uint64_t)AccelerationCount - 1));
+                break;
+            case ObjectBehaviorKeyword::RandomCombinedDirection:
+                stack.push_front((std::uint32_t)arguments.randomizer->get(0, 
+                                 (std::uint64_t)CombinedTubeCount - 1));
+                break;
+            case ObjectBehaviorKeyword::RandomDirection:
+                stack.push_front((std::uint32_t)arguments.randomizer->get(0, 
+                                 (std::uint64_t)DirectionCount - 1));
+                break;
+            case ObjectBehaviorKeyword::RandomDoubleDirection:
+                stack.push_front((std::uint32_t)arguments.randomizer->get(0, 
+                                 (std::uint64_t)DoubleDirectionCount - 1));
+                break;
+            case ObjectBehaviorKeyword::IntRandomValue:
+                stack.front() = (std::uint32_t)arguments.randomizer->get(0,
+                                                                         stack.front());
+                break;
+            case ObjectBehaviorKeyword::RememberedInt:
+                stack.push_front(target.remembered);
+                break;
+            case ObjectBehaviorKeyword::Not:
+                stack.front() = static_cast<std::uint32_t>(!static_cast<bool>(stack.front()));
+                break;
+            case ObjectBehaviorKeyword::OppositeDirection:
+                stack.front() = (std::uint32_t)oppositeDirection(Direction(stack.front()));
+                break;
+            case ObjectBehaviorKeyword::OppositeAcceleration:
+                stack.front() = (std::uint32_t)oppositeAcceleration((Acceleration)stack.front());
+                break;
+            case ObjectBehaviorKeyword::Or:
+            {
+                bool reserved = stack.front();
+                stack.pop_front();
+                stack.front() =
+                    static_cast<std::uint32_t>(reserved || static_cast<bool>(stack.front()));
+                break;
+            }
+            case ObjectBehaviorKeyword::And:
+            {
+                bool reserved = stack.front();
+                stack.pop_front();
+                stack.front() =
+                    static_cast<std::uint32_t>(reserved && static_cast<bool>(stack.front()));
+                break;
+            }
+            case ObjectBehaviorKeyword::Equal:
+            {
+                std::uint32_t reserved = stack.front();
+                stack.pop_front();
+                stack.front() = std::uint32_t(stack.front() == reserved);
+                break;
+            }
+            case ObjectBehaviorKeyword::Select:
+            {
+                bool selectFarther = stack.front();
+                stack.pop_front();
+
+                if (selectFarther)
+                    stack.pop_front();
+                else
+                    stack.erase_after(stack.begin());
+
+                break;
+            }
+            case ObjectBehaviorKeyword::IsDirExitOfDoubleDir:
+            {
+                Direction reserved = (Direction)stack.front();
+                stack.pop_front();
+                stack.front() = (std::uint32_t)directionIsExit((DoubleDirection)stack.front(), reserved);
+                break;
+            }
+            case ObjectBehaviorKeyword::GetCombDirExit:
+            {
+                CombinedDirection reserved = (CombinedDirection)stack.front();
+                stack.pop_front();
+                stack.front() = (std::uint32_t)getCombinedTubeExit(reserved, (Direction)stack.front());
+                break;
+            }
+            case ObjectBehaviorKeyword::SnakeAcceleration:
+                stack.push_front((std::uint32_t)target.snakeAcceleration);
+                break;
+            case ObjectBehaviorKeyword::SnakeDirection:
+                stack.push_front((std::uint32_t)target.snakeDirection);
+                break;
+            case ObjectBehaviorKeyword::PreviousSnakeDirection:
+                stack.push_front((std::uint32_t)arguments.previousSnakeDirection);
+                break;
+            case ObjectBehaviorKeyword::ParamAcceleration:
+            case ObjectBehaviorKeyword::ParamDirection:
+            case ObjectBehaviorKeyword::ParamDoubleDirection:
+            case ObjectBehaviorKeyword::ParamCombinedDirection:
+                stack.push_front(arguments.parameter);
+                break;
+            case ObjectBehaviorKeyword::Int:
+                isInteger = true;
+                break;
+            case ObjectBehaviorKeyword::IntAdd:
+            {
+                std::uint32_t intval = stack.front();
+                stack.pop_front();
+                stack.front() += intval;
+                break;
+            }
+            case ObjectBehaviorKeyword::IntSubtract:
+            {
+                std::uint32_t intval = stack.front();
+                stack.pop_front();
+                stack.front() -= intval;
+                break;
+            }
+            case ObjectBehaviorKeyword::IntAddOverflow:
+            {
+                std::uint32_t intval = stack.front();
+                stack.pop_front();
+                stack.front() = (UINT32_MAX - intval < stack.front());
+                break;
+            }
+            case ObjectBehaviorKeyword::IntBitAnd:
+            {
+                std::uint32_t intval = stack.front();
+                stack.pop_front();
+                stack.front() &= intval;
+                break;
+            }
+            case ObjectBehaviorKeyword::IntBitNot:
+                stack.front() = ~stack.front();
+                break;
+            case ObjectBehaviorKeyword::IntBitOr:
+            {
+                std::uint32_t intval = stack.front();
+                stack.pop_front();
+                stack.front() |= intval;
+                break;
+            }
+            case ObjectBehaviorKeyword::IntBitXor:
+            {
+                std::uint32_t intval = stack.front();
+                stack.pop_front();
+                stack.front() ^= intval;
+                break;
+            }
+            case ObjectBehaviorKeyword::IntCountOfOnes:
+            {
+                unsigned int howmany = 0;
+                for (std::uint32_t i = 1; i; i <<= 1) {
+                    if (stack.front() & i)
+                        ++howmany;
+                }
+                stack.front() = howmany;
+                break;
+            }
+            case ObjectBehaviorKeyword::IntCyclicLeftShift:
+            {
+                std::uint32_t intmod = stack.front();
+                stack.pop_front();
+                intmod %= 32;
+                std::uint32_t intsrc = stack.front();
+                stack.front() <<= intmod;
+                intsrc >>= (32 - intmod);
+                stack.front() |= intsrc;
+                break;
+            }
+            case ObjectBehaviorKeyword::IntCyclicRightShift:
+            {
+                std::uint32_t intmod = stack.front();
+                stack.pop_front();
+                intmod %= 32;
+                std::uint32_t intsrc = stack.front();
+                stack.front() >>= intmod;
+                intsrc <<= (32 - intmod);
+                stack.front() |= intsrc;
+                break;
+            }
+            case ObjectBehaviorKeyword::IntDivideAndFloor:
+            {
+                std::uint32_t divisor = stack.front();
+                stack.pop_front();
+                if (divisor == 0)
+                    stack.front() = 0;
+                else
+                    stack.front() /= divisor;
+                break;
+            }
+            case ObjectBehaviorKeyword::IntLess:
+            {
+                std::uint32_t rightVal = stack.front();
+                stack.pop_front();
+                stack.front() = (stack.front() < rightVal);
+                break;
+            }
+            case ObjectBehaviorKeyword::IntLogicalLeftShift:
+            {
+                std::uint32_t intval = stack.front();
+                stack.pop_front();
+                stack.front() <<= intval;
+                break;
+            }
+            case ObjectBehaviorKeyword::IntLogicalRightShift:
+            {
+                std::uint32_t intval = stack.front();
+                stack.pop_front();
+                stack.front() >>= intval;
+                break;
+            }
+            case ObjectBehaviorKeyword::IntMinus:
+                stack.front() = UINT32_MAX - stack.front();
+                break;
+            case ObjectBehaviorKeyword::IntModulo:
+            {
+                std::uint32_t divisor = stack.front();
+                stack.pop_front();
+                if (divisor == 0)
+                    stack.front() = 0;
+                else
+                    stack.front() %= divisor;
+                break;
+            }
+            case ObjectBehaviorKeyword::IntMultiply:
+            {
+                std::uint32_t intval = stack.front();
+                stack.pop_front();
+                stack.front() *= intval;
+                break;
+            }
+            case ObjectBehaviorKeyword::IntMultiplyOverflow:
+            {
+                std::uint64_t intval = stack.front();
+                stack.pop_front();
+                std::uint64_t product64 = intval * stack.front();
+                stack.front() = (product64 > UINT32_MAX);
+                break;
+            }
+            case ObjectBehaviorKeyword::ExpressionEnd:
+            default:
+                again = false;
+                break;
+            }
+        }
+
+        ++pointer;
+    }
+
+    return stack.front();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void legacyActivate(const ObjectBehavior& behavior,
+                    ExecutionTarget& target,
+                    const ExecutionArguments& arguments) {
+    if (!behavior.getCommandCount())
+        return;
+
+    std::size_t commandIndex = 0;
+    while (commandIndex < behavior.getConditionCount()) {
+        const auto& currentExpression = behavior.getConditionExpression(commandIndex);
+
+        if (legacyComputeValueExpression(currentExpression.data(),
+            currentExpression.size(), target, arguments))
+            break;
+
+        ++commandIndex;
+    }
+
+    // If without else
+    if (commandIndex >= behavior.getCommandCount())
+        return;
+
+    const auto& activeModifyExpression = behavior.getModifyExpression(commandIndex);
+
+    switch (behavior.getCommand(commandIndex)) {
+    case ObjectCommand::KillSnake:
+        target.alive = false;
+        break;
+    case ObjectCommand::StopSnake:
+        target.moving = false;
+        break;
+    case ObjectCommand::ModifyAcceleration:
+        target.snakeAcceleration =
+            (Acceleration)legacyComputeValueExpression(activeModifyExpression.data(),
+                                      activeModifyExpression.size(), target, arguments);
+        break;
+    case ObjectCommand::ModifyDirection:
+        target.snakeDirection =
+            (Direction)legacyComputeValueExpression(activeModifyExpression.data(),
+                                   activeModifyExpression.size(), target, arguments);
+        break;
+    case ObjectCommand::Remember:
+        target.remembered = legacyComputeValueExpression(activeModifyExpression.data(),
+                                                   activeModifyExpression.size(), target, arguments);
+        break;
+    default:
+        break;
+    }
+}
+
+
+// One activation of the workload
+struct Sample {
+    std::size_t behavior;
+    ExecutionTarget target;
+    Direction previousDirection;
+    std::uint32_t parameter;
+};
+
+
+std::uint32_t generateParameter(ObjectParameterType type, Randomizer& randomizer) {
+    switch (type) {
+    case ObjectParameterType::Acceleration:
+        return (std::uint32_t)randomizer.get(0, AccelerationCount - 1);
+    case ObjectParameterType::Direction:
+        return (std::uint32_t)randomizer.get(0, DirectionCount - 1);
+    case ObjectParameterType::DoubleDirection:
+        return (std::uint32_t)randomizer.get(0, DoubleDirectionCount - 1);
+    case ObjectParameterType::CombinedDirection:
+        return (std::uint32_t)randomizer.get(0, CombinedTubeCount - 1);
+    default:
+        return 0;
+    }
+}
+
+
+bool operator!=(const ExecutionTarget& left, const ExecutionTarget& right) noexcept {
+    return left.snakeAcceleration != right.snakeAcceleration ||
+           left.snakeDirection != right.snakeDirection ||
+           left.alive != right.alive ||
+           left.moving != right.moving ||
+           left.remembered != right.remembered;
+}
+
+}
+
+namespace Bulletworm {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+std::optional<std::string> BehaviorBenchmark::run(const std::vector<ObjectBehavior>& behaviors,
+                                                  std::uint64_t rounds,
+                                                  std::uint64_t seed,
+                                                  Report& report) {
+    report = Report();
+    report.behaviorCount = behaviors.size();
+
+    for (const auto& behavior : behaviors) {
+        report.maxStackDepth = std::max(report.maxStackDepth, behavior.getStackDepth());
+        report.memoizedCount += behavior.isMemoized();
+    }
+
+    if (behaviors.empty() || !rounds)
+        return {};
+
+    RandomizerImpl sampleRandomizer;
+    sampleRandomizer.setSeed(seed);
+
+    std::vector<Sample> samples(behaviors.size() * rounds);
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        Sample& sample = samples[i];
+        sample.behavior = i % behaviors.size();
+        sample.target.snakeAcceleration = (Acceleration)sampleRandomizer.get(0, AccelerationCount - 1);
+        sample.target.snakeDirection = (Direction)sampleRandomizer.get(0, DirectionCount - 1);
+        sample.target.alive = true;
+        sample.target.moving = true;
+        sample.target.remembered = (std::uint32_t)sampleRandomizer.get(0, 255);
+        sample.previousDirection = (Direction)sampleRandomizer.get(0, DirectionCount - 1);
+        sample.parameter = generateParameter(behaviors[sample.behavior].getParameterType(),
+                                             sampleRandomizer);
+    }
+
+    std::vector<ExecutionTarget> legacyResults(samples.size());
+    std::vector<ExecutionTarget> currentResults(samples.size());
+
+    // Identically seeded, so the random keywords draw the same values
+    RandomizerImpl legacyRandomizer;
+    RandomizerImpl currentRandomizer;
+    legacyRandomizer.setSeed(~seed);
+    currentRandomizer.setSeed(~seed);
+
+    auto measure = [&](auto activate, Randomizer& randomizer,
+                       std::vector<ExecutionTarget>& results) {
+        auto begin = std::chrono::steady_clock::now();
+
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            ExecutionArguments arguments;
+            arguments.previousSnakeDirection = samples[i].previousDirection;
+            arguments.randomizer = &randomizer;
+            arguments.parameter = samples[i].parameter;
+
+            results[i] = samples[i].target;
+            activate(behaviors[samples[i].behavior], results[i], arguments);
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        return (std::int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    };
+
+    report.legacyElapsedNs = measure(legacyActivate, legacyRandomizer, legacyResults);
+    report.currentElapsedNs = measure([](const ObjectBehavior& behavior, ExecutionTarget& target,
+                                         const ExecutionArguments& arguments) {
+        behavior.activate(target, arguments);
+    }, currentRandomizer, currentResults);
+    report.activations = samples.size();
+
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        if (legacyResults[i] != currentResults[i])
+            return "Interpreters disagree on behavior " + std::to_string(samples[i].behavior);
+    }
+
+    return {};
+}
+
+} // namespace Bulletworm
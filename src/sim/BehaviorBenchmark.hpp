@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef BEHAVIOR_BENCHMARK_HPP
+#define BEHAVIOR_BENCHMARK_HPP
+#include "../engine/ObjectBehavior.hpp"
+#include <optional>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Bulletworm {
+
+/// Runs the shipped object behaviors through the current interpreter
+/// and through the former std::forward_list one, checks that both agree
+/// and measures the time per activation.
+class BehaviorBenchmark {
+public:
+
+    struct Report {
+        std::uint64_t activations = 0;         // per interpreter
+        std::size_t behaviorCount = 0;
+        std::size_t maxStackDepth = 0;
+        std::size_t memoizedCount = 0;       // looked up instead of interpreted
+        std::int64_t legacyElapsedNs = 0;
+        std::int64_t currentElapsedNs = 0;
+
+        double getLegacyNsPerActivation() const noexcept {
+            return activations ? (double)legacyElapsedNs / activations : 0.;
+        }
+
+        double getCurrentNsPerActivation() const noexcept {
+            return activations ? (double)currentElapsedNs / activations : 0.;
+        }
+    };
+
+    /// Activates every behavior 'rounds' times with random targets.
+    /// Returns an error log if the interpreters disagree.
+    [[nodiscard]] static std::optional<std::string> run(const std::vector<ObjectBehavior>& behaviors,
+                                                        std::uint64_t rounds,
+                                                        std::uint64_t seed,
+                                                        Report& report);
+};
+
+} // namespace Bulletworm
+
+#endif // !BEHAVIOR_BENCHMARK_HPP
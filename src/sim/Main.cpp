@@ -0,0 +1,276 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include "Simulator.hpp"
+#include "BehaviorBenchmark.hpp"
+#include "AllocationCounter.hpp"
+#include "../FilePaths.hpp"
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr <<
+        "Usage: " << program << " [options]\n"
+        "  --data PATH        data.bin to load\n"
+        "  --diffs N          difficulty count in data.bin (3)\n"
+        "  --levels N         level count in data.bin (12)\n"
+        "  --difficulty D     difficulty to play (0)\n"
+        "  --level L          level to play (0)\n"
+        "  --instances N      independent games (one per thread)\n"
+        "  --threads N        worker threads (all cores)\n"
+        "  --seconds S        wall clock budget (5)\n"
+        "  --steps N          moves per game instance, 0 is unlimited (0)\n"
+        "  --seed S           base seed (0)\n"
+        "  --layout L         per cell records: rows or tiles (tiles)\n"
+        "  --level-cache DIR  map the prepared levels from DIR, write them there on a miss\n"
+        "  --record PATH      record one game of the random player (--seed, --steps)\n"
+        "  --replay PATH      play a recorded game back and check its state hashes\n"
+        "  --hash-interval N  steps between the recorded state hashes (64)\n"
+        "  --autopilot D      the lookahead bot plays D moves deep (--threads, --seconds,\n"
+        "                     --steps over all games, --seed)\n"
+        "  --bench-behaviors N  compare the object behavior interpreters over N rounds\n"
+        "                     of every loaded behavior instead of playing\n"
+        "  --bench-prepare N  prepare the level N times and print the mean stage timings\n"
+        "                     (only the first round loads the level, the later ones hit the cache)\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    using namespace Bulletworm;
+
+    std::string dataPath = DATA_PATH;
+    unsigned int diffCount = 3;
+    unsigned int levelCount = 12;
+    unsigned int difficulty = 0;
+    unsigned int levelIndex = 0;
+    std::uint64_t behaviorRounds = 0;
+    std::uint64_t preparationRounds = 0;
+    std::string recordPath;
+    std::string replayPath;
+    std::string levelCachePath;
+    std::uint64_t hashInterval = ReplayRecorder::DefaultHashInterval;
+    unsigned int autopilotDepth = 0;
+    GridLayout layout = GridLayout::Tiled;
+    Simulator::Parameters parameters;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* option = argv[i];
+
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        const char* value = argv[++i];
+
+        if (!std::strcmp(option, "--data"))
+            dataPath = value;
+        else if (!std::strcmp(option, "--diffs"))
+            diffCount = (unsigned int)std::strtoul(value, nullptr, 10);
+        else if (!std::strcmp(option, "--levels"))
+            levelCount = (unsigned int)std::strtoul(value, nullptr, 10);
+        else if (!std::strcmp(option, "--difficulty"))
+            difficulty = (unsigned int)std::strtoul(value, nullptr, 10);
+        else if (!std::strcmp(option, "--level"))
+            levelIndex = (unsigned int)std::strtoul(value, nullptr, 10);
+        else if (!std::strcmp(option, "--instances"))
+            parameters.instanceCount = (unsigned int)std::strtoul(value, nullptr, 10);
+        else if (!std::strcmp(option, "--threads"))
+            parameters.threadCount = (unsigned int)std::strtoul(value, nullptr, 10);
+        else if (!std::strcmp(option, "--seconds"))
+            parameters.durationMcs = (std::int64_t)(std::strtod(value, nullptr) * 1e6);
+        else if (!std::strcmp(option, "--steps"))
+            parameters.stepLimit = std::strtoull(value, nullptr, 10);
+        else if (!std::strcmp(option, "--seed"))
+            parameters.seed = std::strtoull(value, nullptr, 10);
+        else if (!std::strcmp(option, "--layout") && !std::strcmp(value, "rows"))
+            layout = GridLayout::RowMajor;
+        else if (!std::strcmp(option, "--layout") && !std::strcmp(value, "tiles"))
+            layout = GridLayout::Tiled;
+        else if (!std::strcmp(option, "--level-cache"))
+            levelCachePath = value;
+        else if (!std::strcmp(option, "--record"))
+            recordPath = value;
+        else if (!std::strcmp(option, "--replay"))
+            replayPath = value;
+        else if (!std::strcmp(option, "--hash-interval"))
+            hashInterval = std::strtoull(value, nullptr, 10);
+        else if (!std::strcmp(option, "--autopilot"))
+            autopilotDepth = (unsigned int)std::strtoul(value, nullptr, 10);
+        else if (!std::strcmp(option, "--bench-behaviors"))
+            behaviorRounds = std::strtoull(value, nullptr, 10);
+        else if (!std::strcmp(option, "--bench-prepare"))
+            preparationRounds = std::strtoull(value, nullptr, 10);
+        else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!behaviorRounds && !preparationRounds && replayPath.empty() && recordPath.empty() &&
+        !parameters.durationMcs && !parameters.stepLimit) {
+        std::cerr << "Either --seconds or --steps must be positive\n";
+        return EXIT_FAILURE;
+    }
+
+    Simulator simulator;
+    simulator.setLevelCacheDirectory(levelCachePath);
+
+    if (auto log = simulator.loadData(dataPath, diffCount, levelCount)) {
+        std::cerr << *log << '\n';
+        return EXIT_FAILURE;
+    }
+
+    if (behaviorRounds) {
+        BehaviorBenchmark::Report benchReport;
+
+        if (auto log = BehaviorBenchmark::run(simulator.getObjectBehaviors(), behaviorRounds,
+                                              parameters.seed, benchReport)) {
+            std::cerr << *log << '\n';
+            return EXIT_FAILURE;
+        }
+
+        std::cout <<
+            "behaviors:       " << benchReport.behaviorCount << "\n"
+            "max stack depth: " << benchReport.maxStackDepth << "\n"
+            "memoized:        " << benchReport.memoizedCount << "\n"
+            "activations:     " << benchReport.activations << "\n"
+            "legacy ns/act:   " << benchReport.getLegacyNsPerActivation() << "\n"
+            "current ns/act:  " << benchReport.getCurrentNsPerActivation() << "\n";
+
+        return EXIT_SUCCESS;
+    }
+
+    if (!replayPath.empty()) {
+        Simulator::ReplayReport replayReport;
+
+        if (auto log = simulator.playReplay(replayPath, layout, replayReport)) {
+            std::cerr << *log << '\n';
+            return EXIT_FAILURE;
+        }
+
+        std::cout <<
+            "steps:       " << replayReport.result.steps << "\n"
+            "checkpoints: " << replayReport.result.checkpoints << "\n"
+            "seconds:     " << replayReport.elapsedMcs / 1e6 << "\n"
+            "steps/sec:   " << (std::uint64_t)replayReport.getStepsPerSecond() << "\n";
+
+        if (replayReport.result.diverged) {
+            std::cout << "diverged at record " << replayReport.result.divergedRecord << "\n";
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    if (preparationRounds) {
+        LevelPreparation::Timings sum;
+        std::uint64_t cachedRounds = 0;
+
+        for (std::uint64_t round = 0; round < preparationRounds; ++round) {
+            if (auto log = simulator.prepareLevel(difficulty, levelIndex, layout)) {
+                std::cerr << *log << '\n';
+                return EXIT_FAILURE;
+            }
+
+            const LevelPreparation::Timings& timings = simulator.getPreparationTimings();
+            for (int i = 0; i < LevelPreparation::StageCount; ++i)
+                sum.stageMcs[i] += timings.stageMcs[i];
+            sum.elapsedMcs += timings.elapsedMcs;
+            cachedRounds += timings.cached;
+        }
+
+        std::int64_t stageSum = 0;
+
+        std::cout << "mean ms per stage:\n";
+        for (int i = 0; i < LevelPreparation::StageCount; ++i) {
+            std::string name = LevelPreparation::getStageName(LevelPreparation::Stage(i));
+            name.resize(std::max<std::size_t>(name.size() + 1, 23), ' ');
+
+            std::cout << "  " << name << sum.stageMcs[i] / 1e3 / preparationRounds << "\n";
+            stageSum += sum.stageMcs[i];
+        }
+
+        std::cout <<
+            "stage sum ms:            " << stageSum / 1e3 / preparationRounds << "\n"
+            "elapsed ms:              " << sum.elapsedMcs / 1e3 / preparationRounds << "\n"
+            "cached rounds:           " << cachedRounds << "\n";
+
+        return EXIT_SUCCESS;
+    }
+
+    if (auto log = simulator.prepareLevel(difficulty, levelIndex, layout)) {
+        std::cerr << *log << '\n';
+        return EXIT_FAILURE;
+    }
+
+    if (!recordPath.empty()) {
+        if (auto log = simulator.recordReplay(parameters, hashInterval, recordPath)) {
+            std::cerr << *log << '\n';
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    if (autopilotDepth) {
+        Autopilot::Report autopilotReport = simulator.runAutopilot(parameters, autopilotDepth);
+
+        std::cout <<
+            "threads:        " << autopilotReport.threadCount << "\n"
+            "games:          " << autopilotReport.games << "\n"
+            "deaths:         " << autopilotReport.deaths << "\n"
+            "max tail:       " << autopilotReport.maxTailSize << "\n"
+            "moves:          " << autopilotReport.moves << "\n"
+            "simulated:      " << autopilotReport.simulatedMoves << "\n"
+            "seconds:        " << autopilotReport.elapsedMcs / 1e6 << "\n"
+            "decisions/sec:  " << (std::uint64_t)autopilotReport.getDecisionsPerSecond() << "\n"
+            "simulated/sec:  " << (std::uint64_t)autopilotReport.getSimulatedMovesPerSecond() << "\n";
+
+        return EXIT_SUCCESS;
+    }
+
+    std::uint64_t allocationsBefore = getAllocationCount();
+    Simulator::Report report = simulator.run(parameters);
+    std::uint64_t allocations = getAllocationCount() - allocationsBefore;
+
+    std::cout <<
+        "threads:    " << report.threadCount << "\n"
+        "instances:  " << report.instanceCount << "\n"
+        "games:      " << report.games << "\n"
+        "steps:      " << report.steps << "\n"
+        "seconds:    " << report.elapsedMcs / 1e6 << "\n"
+        "steps/sec:  " << (std::uint64_t)report.getStepsPerSecond() << "\n"
+        "allocs:     " << allocations << "\n"
+        "per step:   " << (report.steps ? (double)allocations / report.steps : 0.) << "\n";
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,439 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include "Simulator.hpp"
+#include "../Game.hpp"
+#include "../GraphicalEnums.hpp"
+#include "../ObjectBehaviorLoader.hpp"
+#include "../Constants.hpp"
+#include "../engine/const/AttribEnums.hpp"
+#include <bw_ext/Endianness.hpp>
+#include <bw_ext/random/RandomizerImpl.hpp>
+#include <bw_ext/stream/FileOutputStream.hpp>
+#include <bw_ext/stream/MappedFileInputStream.hpp>
+#include <SFML/System/InputStream.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+// sf::MemoryInputStream equivalent, the headless build has no SFML
+class BufferInputStream : public sf::InputStream {
+public:
+
+    BufferInputStream(const void* data, std::int64_t size) noexcept :
+        m_data(static_cast<const char*>(data)), m_size(size) {}
+
+    virtual sf::Int64 read(void* data, sf::Int64 size) override {
+        sf::Int64 count = std::min(size, m_size - m_offset);
+        if (count > 0) {
+            std::memcpy(data, m_data + m_offset, (std::size_t)count);
+            m_offset += count;
+        }
+        return std::max(count, (sf::Int64)0);
+    }
+
+    virtual sf::Int64 seek(sf::Int64 position) override {
+        m_offset = std::clamp(position, (sf::Int64)0, m_size);
+        return m_offset;
+    }
+
+    virtual sf::Int64 tell() override {
+        return m_offset;
+    }
+
+    virtual sf::Int64 getSize() override {
+        return m_size;
+    }
+
+private:
+
+    const char* m_data;
+    sf::Int64 m_size;
+    sf::Int64 m_offset = 0;
+};
+
+
+// One simulated player
+struct Instance {
+    std::array<Bulletworm::RandomizerImpl, Bulletworm::RandomTypeCount> engineRandomizers;
+    Bulletworm::RandomizerImpl inputRandomizer;
+    Bulletworm::Game game;
+    std::int64_t now = 0;
+    std::uint64_t steps = 0;
+};
+
+}
+
+namespace Bulletworm {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+std::optional<std::string> Simulator::loadData(const std::string& path,
+                                               unsigned int diffCount,
+                                               unsigned int levelCount) {
+    if (diffCount < DiffCountMin || diffCount > DiffCountMax)
+        return "Wrong difficulty count";
+
+    if (levelCount < LevelCountMin || levelCount > LevelCountMax)
+        return "Wrong level count";
+
+    // mapped, the stream doesn't move with the pointer
+    auto dataStream = std::make_unique<MappedFileInputStream>();
+    MappedFileInputStream& minp = *dataStream;
+
+    if (!minp.open(path))
+        return "Failed to load " + path;
+
+    if (minp.getSize() % 4 != 0)
+        return "data.bin: wrong size";
+
+    // COLORS (the simulator doesn't draw)
+    std::array<std::uint32_t, ColorDstCount> colors{};
+    if (!readN2hl(minp, colors.data(), colors.size()))
+        return "data.bin: colors";
+
+    // BEHAVIOR
+    auto objlog{ ObjectBehaviorLoader::loadFromStream(m_objectBehaviors, minp, true) };
+    if (objlog)
+        return objlog;
+
+    // BEHAVIOR MAP
+    for (auto* arr : { &m_objectPreEffects, &m_objectPostEffects, &m_objectTailCapacities1 }) {
+        if (!readN2hl(minp, arr->data(), arr->size()))
+            return "data.bin: behavior map";
+    }
+
+    // LEVELS
+    if (!m_levels.loadFromStream(diffCount, levelCount, minp, true))
+        return "data.bin: levels";
+
+    m_dataStream = std::move(dataStream);
+    m_levelPrepared = false;
+    return {};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+std::optional<std::string> Simulator::prepareLevel(unsigned int difficulty, unsigned int levelIndex,
+                                                   GridLayout layout) {
+    if (difficulty >= m_levels.getDifficultyCount() || levelIndex >= m_levels.getLevelCount())
+        return "No such level";
+
+    // the same as BlockSnake::prepareGame but without the drawing stuff
+
+    GameImpl::LevelPointers levelPtrs;
+    levelPtrs.objectBehs = m_objectBehaviors.data();
+    levelPtrs.postEffectBehIndices = m_objectPostEffects.data();
+    levelPtrs.preEffectBehIndices = m_objectPreEffects.data();
+    levelPtrs.tailCapacities1 = m_objectTailCapacities1.data();
+
+    LevelPreparation::Destination destination;
+    destination.objectMemory = &m_initialObjectMemory;
+    destination.snakePositionProbs = &m_currentSnakePosProbs;
+    destination.itemProbabilities = m_currentItemProbabilities.data();
+    destination.cells = &m_currentCells;
+
+    if (!m_levelPreparation.prepare(m_levels, difficulty, levelIndex, false, layout,
+                                    destination, levelPtrs))
+        return "data.bin: level data";
+
+    m_levelPtrs = levelPtrs;
+    m_difficulty = difficulty;
+    m_levelIndex = levelIndex;
+    m_levelPrepared = true;
+    return {};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+Simulator::Report Simulator::run(const Parameters& parameters) const {
+    Report total;
+
+    if (!m_levelPrepared)
+        return total;
+
+    unsigned int threadCount = parameters.threadCount;
+    if (!threadCount)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    unsigned int instanceCount = parameters.instanceCount;
+    if (!instanceCount)
+        instanceCount = threadCount;
+
+    threadCount = std::min(threadCount, instanceCount);
+
+    std::vector<Report> reports(threadCount);
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount);
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // contiguous slices, the first ones take the remainder
+    unsigned int first = 0;
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        unsigned int count = instanceCount / threadCount + (i < instanceCount % threadCount);
+        workers.emplace_back(&Simulator::runSlice, this, std::cref(parameters),
+                             first, first + count, std::ref(reports[i]));
+        first += count;
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    total.elapsedMcs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    total.threadCount = threadCount;
+    total.instanceCount = instanceCount;
+
+    for (const Report& report : reports) {
+        total.steps += report.steps;
+        total.games += report.games;
+    }
+
+    return total;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+std::optional<std::string> Simulator::recordReplay(const Parameters& parameters,
+                                                   std::uint64_t hashInterval,
+                                                   const std::string& path) const {
+    if (!m_levelPrepared)
+        return "No level prepared";
+
+    std::array<RandomizerImpl, RandomTypeCount> engineRandomizers;
+    RandomizerImpl inputRandomizer;
+    inputRandomizer.setSeed(~parameters.seed);
+
+    Game game;
+    startGame(game, engineRandomizers.data(), parameters.seed);
+
+    ReplayRecorder recorder;
+    recorder.start(parameters.seed, m_difficulty, m_levelIndex, hashInterval);
+
+    std::int64_t now = 0;
+
+    // the same random player as in runSlice, until the death or the step limit
+    while (game.getImpl().isSnakeAlive() &&
+           (!parameters.stepLimit || game.getImpl().getSnakeWorld().getStepCount() < parameters.stepLimit)) {
+        if (!game.getImpl().isSnakeMoving() || !inputRandomizer.get(0, 3)) {
+            Direction direction = (Direction)inputRandomizer.get(0, DirectionCount - 1);
+            game.pushCommand(now, direction);
+            recorder.recordCommand(now, direction);
+        }
+
+        now += std::max(game.getImpl().getFactualSnakePeriod(), (std::intmax_t)1);
+        game.fastForward(now);
+        recorder.recordUpdate(game);
+    }
+
+    recorder.finish(game);
+
+    FileOutputStream foutp;
+    if (!foutp.open(path))
+        return "Failed to open " + path;
+
+    if (!recorder.getReplay().saveToStream(foutp))
+        return "Failed to write " + path;
+
+    return {};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+std::optional<std::string> Simulator::playReplay(const std::string& path, GridLayout layout,
+                                                 ReplayReport& report) {
+    std::vector<char> bytes;
+
+    {
+        std::ifstream finp(path, std::ios::binary | std::ios::ate);
+        if (!finp)
+            return "Failed to load " + path;
+
+        bytes.resize((std::size_t)finp.tellg());
+        finp.seekg(0);
+        if (!finp.read(bytes.data(), (std::streamsize)bytes.size()))
+            return "Failed to read " + path;
+    }
+
+    BufferInputStream minp(bytes.data(), (std::int64_t)bytes.size());
+
+    Replay replay;
+    if (auto log = replay.loadFromStream(minp))
+        return path + ": " + *log;
+
+    if (auto log = prepareLevel(replay.difficulty, replay.levelIndex, layout))
+        return log;
+
+    std::array<RandomizerImpl, RandomTypeCount> engineRandomizers;
+    Game game;
+
+    startGame(game, engineRandomizers.data(), replay.seed);
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    report.result = ReplayPlayer::play(replay, game);
+
+    report.elapsedMcs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    return {};
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+Autopilot::Report Simulator::runAutopilot(const Parameters& parameters, unsigned int depth) const {
+    if (!m_levelPrepared)
+        return {};
+
+    std::array<const Map<std::uint32_t>*, ItemCount> itemProbPtrs{};
+    std::transform(m_currentItemProbabilities.begin(),
+                   m_currentItemProbabilities.end(),
+                   itemProbPtrs.begin(),
+                   [](const Map<std::uint32_t>& src) { return &src; });
+
+    std::array<RandomizerImpl, RandomTypeCount> randomizers;
+    RandomizerImpl::seedStreams(parameters.seed, randomizers.data(), randomizers.size());
+
+    std::array<Randomizer*, RandomTypeCount> allRands{};
+    for (int i = 0; i < RandomTypeCount; ++i)
+        allRands[i] = &randomizers[i];
+
+    GameImpl game{ m_levelPtrs, allRands.data(), m_initialObjectMemory.data(), itemProbPtrs.data() };
+
+    Autopilot::Parameters autopilotParameters;
+    autopilotParameters.depth = depth;
+    autopilotParameters.threadCount = parameters.threadCount;
+    autopilotParameters.moveLimit = parameters.stepLimit;
+    autopilotParameters.durationMcs = parameters.durationMcs;
+
+    return Autopilot::play(game, randomizers.data(), m_initialObjectMemory.data(), autopilotParameters);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void Simulator::startGame(Game& game, RandomizerImpl* randomizers, std::uint64_t seed) const {
+    std::array<const Map<std::uint32_t>*, ItemCount> itemProbPtrs{};
+    std::transform(m_currentItemProbabilities.begin(),
+                   m_currentItemProbabilities.end(),
+                   itemProbPtrs.begin(),
+                   [](const Map<std::uint32_t>& src) { return &src; });
+
+    std::array<Randomizer*, RandomTypeCount> allRands{};
+    for (int i = 0; i < RandomTypeCount; ++i)
+        allRands[i] = &randomizers[i];
+
+    game.restart(GameImpl{ m_levelPtrs, allRands.data(),
+                 m_initialObjectMemory.data(), itemProbPtrs.data() });
+
+    RandomizerImpl::seedStreams(seed, randomizers, RandomTypeCount);
+    game.restart(m_initialObjectMemory.data());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void Simulator::runSlice(const Parameters& parameters, unsigned int first, unsigned int last,
+                         Report& report) const {
+    // must not be reallocated: the games keep pointers to the randomizers
+    std::vector<Instance> instances(last - first);
+
+    std::array<const Map<std::uint32_t>*, ItemCount> itemProbPtrs{};
+    std::transform(m_currentItemProbabilities.begin(),
+                   m_currentItemProbabilities.end(),
+                   itemProbPtrs.begin(),
+                   [](const Map<std::uint32_t>& src) { return &src; });
+
+    for (unsigned int i = 0; i < instances.size(); ++i) {
+        Instance& instance = instances[i];
+        std::uint64_t seed = parameters.seed + first + i;
+
+        // one stream per randomizer type, the same as a replay with the seed
+        RandomizerImpl::seedStreams(seed, instance.engineRandomizers.data(), RandomTypeCount);
+        instance.inputRandomizer.setSeed(~seed);
+
+        std::array<Randomizer*, RandomTypeCount> allRands{};
+        for (int i = 0; i < RandomTypeCount; ++i)
+            allRands[i] = &instance.engineRandomizers[i];
+
+        instance.game.restart(GameImpl{ m_levelPtrs, allRands.data(),
+                              m_initialObjectMemory.data(), itemProbPtrs.data() });
+    }
+
+    std::array<Game::Event, 32> gameEvents;
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::uint64_t finished = 0;
+    bool again = !instances.empty();
+
+    while (again) {
+        // check the clock once per batch
+        for (int batch = 0; batch < 64; ++batch) {
+            for (Instance& instance : instances) {
+                if (parameters.stepLimit && instance.steps >= parameters.stepLimit)
+                    continue;
+
+                Game& game = instance.game;
+
+                // random player: turn now and then
+                if (!game.getImpl().isSnakeMoving() || !instance.inputRandomizer.get(0, 3))
+                    game.pushCommand(instance.now,
+                                     (Direction)instance.inputRandomizer.get(0, DirectionCount - 1));
+
+                instance.now += std::max(game.getImpl().getFactualSnakePeriod(), (std::intmax_t)1);
+                // nothing is presented, only the moves are counted
+                game.fastForward(instance.now, 1u << (int)MainGameEvent::Moved);
+
+                std::size_t eventCount;
+                while ((eventCount = game.pollEvents(gameEvents.data(), gameEvents.size())) != 0)
+                    for (std::size_t i = 0; i < eventCount; ++i)
+                        if (gameEvents[i].isMain && gameEvents[i].mainGameEvent == MainGameEvent::Moved)
+                            ++instance.steps;
+
+                if (!game.getImpl().isSnakeAlive()) {
+                    game.restart(m_initialObjectMemory.data());
+                    instance.now = 0;
+                    ++report.games;
+                }
+
+                if (parameters.stepLimit && instance.steps >= parameters.stepLimit)
+                    ++finished;
+            }
+        }
+
+        std::int64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+
+        again = (finished < instances.size()) &&
+            (!parameters.durationMcs || elapsed < parameters.durationMcs);
+    }
+
+    for (const Instance& instance : instances)
+        report.steps += instance.steps;
+}
+
+} // namespace Bulletworm
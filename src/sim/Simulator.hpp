@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////
+//
+// Bulletworm - Advanced Snake Game
+// Copyright (c) 2024-2025 Oleh Kiprik (oleg.kiprik@proton.me)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SIMULATOR_HPP
+#define SIMULATOR_HPP
+#include "../engine/GameImpl.hpp"
+#include "../engine/ObjectBehavior.hpp"
+#include "../LevelElements.hpp"
+#include "../LevelPreparation.hpp"
+#include "../Levels.hpp"
+#include "../Replay.hpp"
+#include "Autopilot.hpp"
+#include <SFML/System/InputStream.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <array>
+
+namespace Bulletworm {
+
+class Game;
+class RandomizerImpl;
+
+/// Headless batch runner.
+/// Loads data.bin and steps independent Game instances on all cores
+/// without a window, an audio device or a GL context.
+class Simulator {
+public:
+
+    struct Parameters {
+        unsigned int instanceCount = 0;        // 0 means one per thread
+        unsigned int threadCount = 0;          // 0 means hardware concurrency
+        std::uint64_t seed = 0;
+        std::int64_t durationMcs = 5000000;    // wall clock budget
+        std::uint64_t stepLimit = 0;           // per instance, 0 means unlimited
+    };
+
+    struct Report {
+        std::uint64_t steps = 0;               // Snake moves over all instances
+        std::uint64_t games = 0;               // finished games (death or time limit)
+        std::int64_t elapsedMcs = 0;
+        unsigned int threadCount = 0;
+        unsigned int instanceCount = 0;
+
+        double getStepsPerSecond() const noexcept {
+            return elapsedMcs ? steps * 1e6 / elapsedMcs : 0.;
+        }
+    };
+
+    struct ReplayReport {
+        ReplayPlayer::Result result;
+        std::int64_t elapsedMcs = 0;
+
+        double getStepsPerSecond() const noexcept {
+            return elapsedMcs ? result.steps * 1e6 / elapsedMcs : 0.;
+        }
+    };
+
+    [[nodiscard]] std::optional<std::string> loadData(const std::string& path,
+                                                      unsigned int diffCount,
+                                                      unsigned int levelCount);
+
+    /// The prepared levels are cached there (see LevelPreparation), empty disables it
+    void setLevelCacheDirectory(const std::string& directory) {
+        m_levelPreparation.setCacheDirectory(directory);
+    }
+
+    [[nodiscard]] std::optional<std::string> prepareLevel(unsigned int difficulty,
+                                                          unsigned int levelIndex,
+                                                          GridLayout layout = GridLayout::Tiled);
+
+    [[nodiscard]] Report run(const Parameters& parameters) const;
+
+    /// Records one game of the random player (Parameters::seed and stepLimit) on the prepared level
+    [[nodiscard]] std::optional<std::string> recordReplay(const Parameters& parameters,
+                                                          std::uint64_t hashInterval,
+                                                          const std::string& path) const;
+
+    /// The autopilot plays the prepared level (Parameters::seed, threadCount,
+    /// stepLimit as the move limit over all games and durationMcs)
+    [[nodiscard]] Autopilot::Report runAutopilot(const Parameters& parameters, unsigned int depth) const;
+
+    /// Prepares the level of the replay and plays it back as fast as possible
+    [[nodiscard]] std::optional<std::string> playReplay(const std::string& path, GridLayout layout,
+                                                        ReplayReport& report);
+
+    const Levels& getLevels() const noexcept {
+        return m_levels;
+    }
+
+    const std::vector<ObjectBehavior>& getObjectBehaviors() const noexcept {
+        return m_objectBehaviors;
+    }
+
+    /// Of the last prepareLevel
+    const LevelPreparation::Timings& getPreparationTimings() const noexcept {
+        return m_levelPreparation.getTimings();
+    }
+
+private:
+
+    // The way BlockSnake starts a game: the streams are seeded just before the restart
+    void startGame(Game& game, RandomizerImpl* randomizers, std::uint64_t seed) const;
+
+    // Steps the instances [first, last) until the budget is spent
+    void runSlice(const Parameters& parameters, unsigned int first, unsigned int last,
+                  Report& report) const;
+
+    // data.bin
+    std::unique_ptr<sf::InputStream> m_dataStream;   // mapped, the levels read it on demand
+    Levels m_levels;
+    std::vector<ObjectBehavior> m_objectBehaviors;
+    std::array<std::uint32_t, ObjectPairCount> m_objectPreEffects{};
+    std::array<std::uint32_t, ObjectPairCount> m_objectPostEffects{};
+    std::array<std::uint32_t, ObjectPairCount> m_objectTailCapacities1{};
+
+    // current prepared level (read-only while running)
+    LevelPreparation m_levelPreparation;
+    GameImpl::LevelPointers m_levelPtrs;
+    std::array<Map<std::uint32_t>, ItemCount> m_currentItemProbabilities;
+    FenwickSampler<1> m_currentSnakePosProbs;
+    CellGrid<GameImpl::CellRecord> m_currentCells;
+    ElementStorage<std::uint32_t> m_initialObjectMemory;   // may borrow a cached level image
+    unsigned int m_difficulty = 0;
+    unsigned int m_levelIndex = 0;
+    bool m_levelPrepared = false;
+};
+
+} // namespace Bulletworm
+
+#endif // !SIMULATOR_HPP